@@ -0,0 +1,42 @@
+#include "./BinaryReader.hh"
+
+
+void BinaryReader::writeNumber(std::string &output, const std::uint32_t number)
+{
+	// Numbers are always stored in little endian, regardless of the platform.
+	for (unsigned i = 0; i != 4; ++i)
+		output.push_back(static_cast<char>((number >> (i * 8)) & 0xFF));
+}
+
+void BinaryReader::writeString(std::string &output, const std::string_view string)
+{
+	writeNumber(output, static_cast<std::uint32_t>(string.size()));
+	output.append(string);
+}
+
+std::uint8_t BinaryReader::readByte()
+{
+	const std::string_view byte = readBytes(1);
+	return byte.empty() ? 0 : static_cast<std::uint8_t>(byte.front());
+}
+
+std::uint32_t BinaryReader::readNumber()
+{
+	const std::string_view bytes = readBytes(4);
+	std::uint32_t number = 0;
+	for (std::size_t i = 0; i != bytes.size(); ++i)
+		number |= static_cast<std::uint32_t>(static_cast<unsigned char>(bytes[i])) << (i * 8);
+	return number;
+}
+
+std::string_view BinaryReader::readBytes(const std::size_t count)
+{
+	if (error || count > data.size())
+	{
+		error = true;
+		return {};
+	}
+	const std::string_view bytes = data.substr(0, count);
+	data.remove_prefix(count);
+	return bytes;
+}
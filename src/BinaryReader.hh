@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+
+// A reader of the binary input format. (See `Karnaughs::printBinary` for its layout.)
+// Reading past the end of data doesn't throw; it only sets the error flag.
+class BinaryReader
+{
+	std::string_view data;
+	bool error = false;
+	
+public:
+	static constexpr std::string_view MAGIC = std::string_view("\0karnaugh-tt-1\n", 15);
+	
+	[[nodiscard]] static bool isBinary(const std::string_view contents) { return contents.substr(0, MAGIC.size()) == MAGIC; }
+	static void writeNumber(std::string &output, const std::uint32_t number);
+	static void writeString(std::string &output, const std::string_view string);
+	
+	explicit BinaryReader(const std::string_view contents) : data(contents.substr(MAGIC.size())) {}
+	
+	[[nodiscard]] bool hasError() const { return error; }
+	[[nodiscard]] bool isAtEnd() const { return data.empty(); }
+	
+	[[nodiscard]] std::uint8_t readByte();
+	[[nodiscard]] std::uint32_t readNumber();
+	[[nodiscard]] std::string_view readBytes(const std::size_t count);
+	[[nodiscard]] std::string_view readString() { return readBytes(readNumber()); }
+};
@@ -0,0 +1,145 @@
+#include "./CoverageTable.hh"
+
+#include <algorithm>
+#include <bitset>
+
+
+CoverageTable::CoverageTable(const Minterms &minterms, const std::vector<Implicant> &primeImplicants, Progress &progress) :
+	CoverageTable(minterms.size(), primeImplicants.size())
+{
+	// The masks are copied to flat arrays, so the inner loop doesn't need to go through `Implicant`.
+	std::vector<Implicant::mask_t> trueBits, falseBits;
+	trueBits.reserve(wordsPerRow * WORD_BITS);
+	falseBits.reserve(wordsPerRow * WORD_BITS);
+	for (const Implicant &primeImplicant : primeImplicants)
+	{
+		trueBits.push_back(primeImplicant.getTrueBits());
+		falseBits.push_back(primeImplicant.getFalseBits());
+	}
+	// The padding of the last word is filled with implicants that cover nothing.
+	trueBits.resize(wordsPerRow * WORD_BITS, ~Implicant::mask_t(0));
+	falseBits.resize(wordsPerRow * WORD_BITS, ~Implicant::mask_t(0));
+	
+	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(rowCount));
+	std::size_t row = 0;
+	for (const Minterm minterm : minterms)
+	{
+		progressStep.substep();
+		const Implicant::mask_t mintermBits = static_cast<Implicant::mask_t>(minterm);
+		word_t *const rowWords = getRow(row++);
+		for (std::size_t i = 0; i != wordsPerRow; ++i)
+		{
+			const Implicant::mask_t *const wordTrueBits = trueBits.data() + i * WORD_BITS;
+			const Implicant::mask_t *const wordFalseBits = falseBits.data() + i * WORD_BITS;
+			word_t word = 0;
+			for (std::size_t j = 0; j != WORD_BITS; ++j)
+				word |= word_t(((wordTrueBits[j] & ~mintermBits) | (wordFalseBits[j] & mintermBits)) == 0) << j;
+			rowWords[i] = word;
+		}
+	}
+}
+
+std::vector<CoverageTable::word_t> CoverageTable::makeColumnMask(const selection_t &columns) const
+{
+	std::vector<word_t> mask(wordsPerRow, 0);
+	for (std::size_t column = 0; column != columnCount; ++column)
+		if (columns[column])
+			mask[column / WORD_BITS] |= word_t(1) << (column % WORD_BITS);
+	return mask;
+}
+
+std::size_t CoverageTable::countRow(const std::size_t row) const
+{
+	const word_t *const rowWords = getRow(row);
+	std::size_t count = 0;
+	for (std::size_t i = 0; i != wordsPerRow; ++i)
+		count += std::bitset<WORD_BITS>(rowWords[i]).count();
+	return count;
+}
+
+std::size_t CoverageTable::findFirstInRow(const std::size_t row) const
+{
+	const word_t *const rowWords = getRow(row);
+	for (std::size_t i = 0; i != wordsPerRow; ++i)
+		if (rowWords[i] != 0)
+			return i * WORD_BITS + std::bitset<WORD_BITS>((rowWords[i] & (~rowWords[i] + 1)) - 1).count();
+	return SIZE_MAX;
+}
+
+std::vector<std::size_t> CoverageTable::listRow(const std::size_t row) const
+{
+	std::vector<std::size_t> columns;
+	const word_t *const rowWords = getRow(row);
+	for (std::size_t i = 0; i != wordsPerRow; ++i)
+		for (word_t word = rowWords[i]; word != 0; word &= word - 1)
+			columns.push_back(i * WORD_BITS + std::bitset<WORD_BITS>((word & (~word + 1)) - 1).count());
+	return columns;
+}
+
+bool CoverageTable::isRowSubset(const std::size_t subsetRow, const std::size_t supersetRow) const
+{
+	const word_t *const subsetWords = getRow(subsetRow);
+	const word_t *const supersetWords = getRow(supersetRow);
+	word_t difference = 0;
+	for (std::size_t i = 0; i != wordsPerRow; ++i)
+		difference |= subsetWords[i] & ~supersetWords[i];
+	return difference == 0;
+}
+
+CoverageTable::selection_t CoverageTable::findRowsIntersecting(const selection_t &columns) const
+{
+	const std::vector<word_t> mask = makeColumnMask(columns);
+	selection_t rows(rowCount, false);
+	for (std::size_t row = 0; row != rowCount; ++row)
+	{
+		const word_t *const rowWords = getRow(row);
+		word_t intersection = 0;
+		for (std::size_t i = 0; i != wordsPerRow; ++i)
+			intersection |= rowWords[i] & mask[i];
+		rows[row] = intersection != 0;
+	}
+	return rows;
+}
+
+void CoverageTable::clearColumns(const selection_t &columns)
+{
+	const std::vector<word_t> mask = makeColumnMask(columns);
+	for (std::size_t row = 0; row != rowCount; ++row)
+	{
+		word_t *const rowWords = getRow(row);
+		for (std::size_t i = 0; i != wordsPerRow; ++i)
+			rowWords[i] &= ~mask[i];
+	}
+}
+
+CoverageTable CoverageTable::select(const selection_t &rows, const selection_t &columns) const
+{
+	std::vector<std::size_t> selectedColumns;
+	for (std::size_t column = 0; column != columnCount; ++column)
+		if (columns[column])
+			selectedColumns.push_back(column);
+	CoverageTable selection(static_cast<std::size_t>(std::count(rows.cbegin(), rows.cend(), true)), selectedColumns.size());
+	std::size_t newRow = 0;
+	for (std::size_t row = 0; row != rowCount; ++row)
+	{
+		if (!rows[row])
+			continue;
+		if (selectedColumns.size() == columnCount)
+			std::copy_n(getRow(row), wordsPerRow, selection.getRow(newRow));
+		else
+			for (std::size_t newColumn = 0; newColumn != selectedColumns.size(); ++newColumn)
+				if (get(row, selectedColumns[newColumn]))
+					selection.set(newRow, newColumn);
+		++newRow;
+	}
+	return selection;
+}
+
+CoverageTable CoverageTable::transpose() const
+{
+	CoverageTable transposition(columnCount, rowCount);
+	for (std::size_t row = 0; row != rowCount; ++row)
+		for (const std::size_t column : listRow(row))
+			transposition.set(column, row);
+	return transposition;
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "Implicant.hh"
+#include "Minterms.hh"
+#include "Progress.hh"
+
+
+// A bit matrix that tells which prime implicants (columns) cover which minterms (rows).
+// Each row is stored as a continuous array of words, so operations on whole rows are simple loops that the compiler can vectorize.
+class CoverageTable
+{
+	using word_t = std::uint64_t;
+	static constexpr std::size_t WORD_BITS = 64;
+	
+	std::size_t rowCount = 0, columnCount = 0, wordsPerRow = 0;
+	std::vector<word_t> words;
+	
+	[[nodiscard]] word_t* getRow(const std::size_t row) { return words.data() + row * wordsPerRow; }
+	[[nodiscard]] const word_t* getRow(const std::size_t row) const { return words.data() + row * wordsPerRow; }
+	[[nodiscard]] std::vector<word_t> makeColumnMask(const std::vector<bool> &columns) const;
+	
+public:
+	using selection_t = std::vector<bool>;
+	
+	CoverageTable() = default;
+	CoverageTable(const std::size_t rowCount, const std::size_t columnCount) : rowCount(rowCount), columnCount(columnCount), wordsPerRow((columnCount + WORD_BITS - 1) / WORD_BITS), words(rowCount * wordsPerRow, 0) {}
+	CoverageTable(const Minterms &minterms, const std::vector<Implicant> &primeImplicants, Progress &progress);
+	
+	[[nodiscard]] std::size_t getRowCount() const { return rowCount; }
+	[[nodiscard]] std::size_t getColumnCount() const { return columnCount; }
+	
+	[[nodiscard]] bool get(const std::size_t row, const std::size_t column) const { return (getRow(row)[column / WORD_BITS] >> (column % WORD_BITS) & 1) != 0; }
+	void set(const std::size_t row, const std::size_t column) { getRow(row)[column / WORD_BITS] |= word_t(1) << (column % WORD_BITS); }
+	
+	[[nodiscard]] std::size_t countRow(const std::size_t row) const;
+	[[nodiscard]] std::size_t findFirstInRow(const std::size_t row) const;
+	[[nodiscard]] std::vector<std::size_t> listRow(const std::size_t row) const;
+	[[nodiscard]] bool isRowSubset(const std::size_t subsetRow, const std::size_t supersetRow) const;
+	[[nodiscard]] selection_t findRowsIntersecting(const selection_t &columns) const;
+	
+	void clearColumns(const selection_t &columns);
+	[[nodiscard]] CoverageTable select(const selection_t &rows, const selection_t &columns) const;
+	[[nodiscard]] CoverageTable transpose() const;
+};
@@ -4,121 +4,224 @@
 
 
 template<typename VALUE_T>
-bool HasseDiagram<VALUE_T>::containsSubset(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const Node &currentNode)
+typename HasseDiagram<VALUE_T>::index_t HasseDiagram<VALUE_T>::makeNode(const value_t value, const index_t parent)
 {
-	for (; currentInSet != endOfSet; ++currentInSet)
-		if (const auto foundChild = currentNode.children.find(*currentInSet); foundChild != currentNode.children.end())
-			if (containsSubset(std::next(currentInSet), endOfSet, foundChild->getNode()))
+	// A node is freed only when it has no children, so a reused one doesn't need to be cleaned up. (It keeps its block of children.)
+	if (!freeNodes.empty())
+	{
+		const index_t node = freeNodes.back();
+		freeNodes.pop_back();
+		nodes[node].value = value;
+		nodes[node].parent = parent;
+		return node;
+	}
+	nodes.push_back(Node{0, 0, 0, value, parent});
+	return static_cast<index_t>(nodes.size() - 1);
+}
+
+template<typename VALUE_T>
+void HasseDiagram<VALUE_T>::growChildren(const index_t node)
+{
+	Node &n = nodes[node];
+	const index_t newCapacity = n.childCapacity == 0 ? 2 : n.childCapacity * 2;
+	std::size_t newCapacityLog = 0;
+	while ((index_t(1) << newCapacityLog) != newCapacity)
+		++newCapacityLog;
+	if (freeChildBlocks.size() <= newCapacityLog)
+		freeChildBlocks.resize(newCapacityLog + 1);
+	index_t newFirstChild;
+	if (!freeChildBlocks[newCapacityLog].empty())
+	{
+		newFirstChild = freeChildBlocks[newCapacityLog].back();
+		freeChildBlocks[newCapacityLog].pop_back();
+	}
+	else
+	{
+		newFirstChild = static_cast<index_t>(childPool.size());
+		childPool.resize(childPool.size() + newCapacity);
+	}
+	std::copy_n(childPool.cbegin() + n.firstChild, n.childCount, childPool.begin() + newFirstChild);
+	if (n.childCapacity != 0)
+		freeChildBlocks[newCapacityLog - 1].push_back(n.firstChild);
+	n.firstChild = newFirstChild;
+	n.childCapacity = newCapacity;
+}
+
+template<typename VALUE_T>
+void HasseDiagram<VALUE_T>::insertChild(const index_t node, const NodeChild child)
+{
+	if (nodes[node].childCount == nodes[node].childCapacity)
+		growChildren(node);
+	const ChildrenView<NodeChild> children = getChildren(node);
+	NodeChild *const position = children.lowerBound(child.key);
+	std::copy_backward(position, children.end(), children.end() + 1);
+	*position = child;
+	++nodes[node].childCount;
+}
+
+template<typename VALUE_T>
+void HasseDiagram<VALUE_T>::eraseChild(const index_t node, const value_t key)
+{
+	const ChildrenView<NodeChild> children = getChildren(node);
+	NodeChild *const child = children.find(key);
+	std::copy(child + 1, children.end(), child);
+	--nodes[node].childCount;
+}
+
+template<typename VALUE_T>
+typename HasseDiagram<VALUE_T>::index_t HasseDiagram<VALUE_T>::makeReferences(const index_t reference)
+{
+	if (!freeReferenceLists.empty())
+	{
+		const index_t references = freeReferenceLists.back();
+		freeReferenceLists.pop_back();
+		referenceLists[references].push_back(reference);
+		return references;
+	}
+	referenceLists.push_back(references_t{reference});
+	return static_cast<index_t>(referenceLists.size() - 1);
+}
+
+template<typename VALUE_T>
+typename HasseDiagram<VALUE_T>::index_t HasseDiagram<VALUE_T>::findOrMakeChild(const index_t node, const value_t value)
+{
+	const ChildrenView<NodeChild> children = getChildren(node);
+	if (const NodeChild *const found = children.find(value); found != children.end())
+		return found->index;
+	const index_t child = makeNode(value, node);
+	insertChild(node, {value, child});
+	return child;
+}
+
+template<typename VALUE_T>
+bool HasseDiagram<VALUE_T>::containsSubset(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode, const std::size_t maxSize) const
+{
+	// Both the set and the children are sorted, so they are walked together.
+	const ChildrenView<const NodeChild> children = getChildren(currentNode);
+	if (maxSize != 0)
+	{
+		const NodeChild *child = children.begin();
+		for (; currentInSet != endOfSet; ++currentInSet)
+		{
+			while (child != children.end() && child->key < *currentInSet)
+				++child;
+			if (child == children.end())
+				return false;
+			if (child->key == *currentInSet && containsSubset(std::next(currentInSet), endOfSet, child->index, maxSize - 1))
 				return true;
-	return currentNode.children.find(TOP_NODE) != currentNode.children.cend();
+		}
+	}
+	return children.find(TOP_NODE) != children.end();
 }
 
 template<typename VALUE_T>
-typename HasseDiagram<VALUE_T>::Node& HasseDiagram<VALUE_T>::insert(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, Node &currentNode)
+typename HasseDiagram<VALUE_T>::index_t HasseDiagram<VALUE_T>::insert(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode)
 {
 	++size;
-	Node *nextNode;
-	if (const auto foundChild = currentNode.children.find(*currentInSet); foundChild != currentNode.children.end())
-		nextNode = &foundChild->getNode();
-	else
-		nextNode = &currentNode.children.emplace_back(*currentInSet, new Node{{}, *currentInSet, &currentNode}).getNode();
+	const index_t nextNode = findOrMakeChild(currentNode, *currentInSet);
 	const typename set_t::const_iterator nextInSet = std::next(currentInSet);
-	Node *resultNode;
+	index_t resultNode;
 	if (nextInSet != endOfSet)
 	{
-		resultNode = &insert(nextInSet, endOfSet, *nextNode);
-		insertSideBranch(nextInSet, endOfSet, currentNode, *resultNode);
+		resultNode = insert(nextInSet, endOfSet, nextNode);
+		insertSideBranch(nextInSet, endOfSet, currentNode, resultNode);
 	}
 	else
 	{
 		resultNode = nextNode;
-		nextNode->children.emplace_back();
+		insertChild(nextNode, {TOP_NODE, NO_INDEX});
 	}
-	return *resultNode;
+	return resultNode;
 }
 
 template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::insertSideBranch(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, Node &currentNode, Node &resultNode)
+void HasseDiagram<VALUE_T>::insertSideBranch(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode, const index_t resultNode)
 {
-	Node *nextNode;
-	if (const auto foundChild = currentNode.children.find(*currentInSet); foundChild != currentNode.children.end())
-		nextNode = &foundChild->getNode();
-	else
-		nextNode = &currentNode.children.emplace_back(*currentInSet, new Node{{}, *currentInSet, &currentNode}).getNode();
+	const index_t nextNode = findOrMakeChild(currentNode, *currentInSet);
 	const typename set_t::const_iterator nextInSet = std::next(currentInSet);
 	if (nextInSet != endOfSet)
 	{
-		insertSideBranch(nextInSet, endOfSet, *nextNode, resultNode);
+		insertSideBranch(nextInSet, endOfSet, nextNode, resultNode);
 		insertSideBranch(nextInSet, endOfSet, currentNode, resultNode);
 	}
 	else
 	{
-		if (const auto foundChild = nextNode->children.find(REFERENCES); foundChild != nextNode->children.end())
-			foundChild->getReferences().emplace_back(&resultNode);
+		const ChildrenView<NodeChild> children = getChildren(nextNode);
+		if (const NodeChild *const foundChild = children.find(REFERENCES); foundChild != children.end())
+		{
+			referenceLists[foundChild->index].push_back(resultNode);
+		}
 		else
-			nextNode->children.emplace_back(std::vector<Node*>{&resultNode});
+		{
+			const index_t references = makeReferences(resultNode);
+			insertChild(nextNode, {REFERENCES, references});
+		}
 	}
 }
 
 template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::removeChildren(Node &node)
+void HasseDiagram<VALUE_T>::removeChildren(const index_t node)
 {
 	while (true)
 	{
-		Node *curr = &node;
+		index_t curr = node;
 		while (true)
 		{
-			auto child = curr->children.begin();
+			const ChildrenView<NodeChild> children = getChildren(curr);
+			const NodeChild *child = children.begin();
 			fuck_go_back:
-			if (child == curr->children.end())
+			if (child == children.end())
 				return;
-			switch (child->getKey())
+			switch (child->key)
 			{
 			case TOP_NODE:
-				if (curr == &node)
+				if (curr == node)
 				{
 					++child;
 					goto fuck_go_back;
 				}
 				goto end_loop;
 			case REFERENCES:
-				curr = child->getReferences().front();
+				curr = referenceLists[child->index].front();
 				goto end_loop;
 			default:
-				curr = &child->getNode();
+				curr = child->index;
 			}
 		}
 		end_loop:
-		removeTopNode(*curr);
+		removeTopNode(curr);
 	}
 }
 
 template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::removeTopNode(Node &topNode)
+void HasseDiagram<VALUE_T>::removeTopNode(const index_t topNode)
 {
 	--size;
-	topNode.children.erase(TOP_NODE);
+	eraseChild(topNode, TOP_NODE);
 	std::vector<value_t> &valuesBackwards = workingVector;
 	valuesBackwards.clear();
-	Node *curr = &topNode;
-	while (curr->parent != nullptr)
+	index_t curr = topNode;
+	while (nodes[curr].parent != NO_INDEX)
 	{
 		if (valuesBackwards.size() >= 2)
-			removeSideBranch(std::next(valuesBackwards.crbegin()), valuesBackwards.crend(), *curr, &topNode);
-		valuesBackwards.push_back(curr->value);
-		Node *const parent = curr->parent;
-		if (curr->children.empty())
-			parent->children.erase(valuesBackwards.back());
+			removeSideBranch(std::next(valuesBackwards.crbegin()), valuesBackwards.crend(), curr, topNode);
+		valuesBackwards.push_back(nodes[curr].value);
+		const index_t parent = nodes[curr].parent;
+		if (nodes[curr].childCount == 0)
+		{
+			eraseChild(parent, valuesBackwards.back());
+			freeNode(curr);
+		}
 		curr = parent;
 	}
 	if (valuesBackwards.size() >= 2)
-		removeSideBranch(std::next(valuesBackwards.crbegin()), valuesBackwards.crend(), *curr, &topNode);
+		removeSideBranch(std::next(valuesBackwards.crbegin()), valuesBackwards.crend(), curr, topNode);
 }
 
 template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::removeSideBranch(typename std::vector<value_t>::const_reverse_iterator currentValue, const typename std::vector<value_t>::const_reverse_iterator &endOfValues, Node &startPoint, const Node *const endNode)
+void HasseDiagram<VALUE_T>::removeSideBranch(typename std::vector<value_t>::const_reverse_iterator currentValue, const typename std::vector<value_t>::const_reverse_iterator &endOfValues, const index_t startPoint, const index_t endNode)
 {
-	Node &currentNode = startPoint.children.find(*currentValue)->getNode();
+	const index_t currentNode = getChildren(startPoint).find(*currentValue)->index;
 	const typename std::vector<value_t>::const_reverse_iterator nextValue = std::next(currentValue);
 	if (nextValue != endOfValues)
 	{
@@ -127,31 +230,39 @@ void HasseDiagram<VALUE_T>::removeSideBranch(typename std::vector<value_t>::cons
 	}
 	else
 	{
-		std::vector<Node*> &references = currentNode.children.find(REFERENCES)->getReferences();
+		const index_t referencesIndex = getChildren(currentNode).find(REFERENCES)->index;
+		references_t &references = referenceLists[referencesIndex];
 		references.erase(std::find(references.begin(), references.end(), endNode));
 		if (references.empty())
-			currentNode.children.erase(REFERENCES);
+		{
+			eraseChild(currentNode, REFERENCES);
+			freeReferences(referencesIndex);
+		}
+	}
+	if (nodes[currentNode].childCount == 0)
+	{
+		eraseChild(startPoint, *currentValue);
+		freeNode(currentNode);
 	}
-	if (currentNode.children.empty())
-		startPoint.children.erase(*currentValue);
 }
 
 template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::getSets(sets_t &sets, const Node &currentNode) const
+void HasseDiagram<VALUE_T>::getSets(sets_t &sets, const index_t currentNode) const
 {
 	set_t &currentSet = workingVector;
-	if (currentNode.children.find(TOP_NODE) != currentNode.children.cend())
+	const ChildrenView<const NodeChild> children = getChildren(currentNode);
+	if (children.find(TOP_NODE) != children.end())
 	{
 		sets.emplace_back(currentSet);
 	}
 	else
 	{
-		for (const auto &child : currentNode.children)
+		for (const NodeChild &child : children)
 		{
-			if (child.getKey() != REFERENCES)
+			if (child.key != REFERENCES)
 			{
-				currentSet.push_back(child.getKey());
-				getSets(sets, child.getNode());
+				currentSet.push_back(child.key);
+				getSets(sets, child.index);
 				currentSet.pop_back();
 			}
 		}
@@ -164,7 +275,7 @@ typename HasseDiagram<VALUE_T>::sets_t HasseDiagram<VALUE_T>::getSets() const
 	workingVector.clear();
 	sets_t sets;
 	sets.reserve(size);
-	getSets(sets, root);
+	getSets(sets, ROOT);
 	sets.shrink_to_fit();
 	return sets;
 }
@@ -172,9 +283,9 @@ typename HasseDiagram<VALUE_T>::sets_t HasseDiagram<VALUE_T>::getSets() const
 template<typename VALUE_T>
 bool HasseDiagram<VALUE_T>::insertRemovingSupersets(const set_t &set)
 {
-	if (containsSubset(set.cbegin(), set.cend(), root))
+	if (containsSubset(set))
 		return false;
-	Node &added = insert(set.cbegin(), set.cend(), root);
+	const index_t added = insert(set.cbegin(), set.cend(), ROOT);
 	removeChildren(added);
 	return true;
 }
@@ -185,4 +296,3 @@ bool HasseDiagram<VALUE_T>::insertRemovingSupersets(const set_t &set)
 template class HasseDiagram<std::uint8_t>;
 template class HasseDiagram<std::uint16_t>;
 template class HasseDiagram<std::uint32_t>;
-template class HasseDiagram<std::uint64_t>;
@@ -1,6 +1,9 @@
 #pragma once
 
+#include <algorithm>
 #include <cstddef>
+#include <cstdint>
+#include <deque>
 #include <vector>
 
 
@@ -16,120 +19,77 @@ public:
 private:
 	static constexpr value_t TOP_NODE = static_cast<value_t>(~value_t(0) - 1), REFERENCES = static_cast<value_t>(~value_t(0));
 	
-	struct Node;
-	using references_t = std::vector<Node*>;
-	class NodeChild
+	// Nodes, their arrays of children and lists of references live in arenas owned by the diagram and they refer to each other by 32-bit indices.
+	// Removed nodes and lists are reused by later insertions (together with their capacity) and everything is freed at once with the diagram.
+	using index_t = std::uint32_t;
+	static constexpr index_t NO_INDEX = ~index_t(0);
+	using references_t = std::vector<index_t>;
+	struct NodeChild
 	{
-		value_t key = TOP_NODE;
-		union
-		{
-			Node *node;
-			references_t references;
-		};
-		
-		inline void moveValue(NodeChild &&other);
-		inline void deconstructValue();
-		
-	public:
-		NodeChild(const value_t key, Node *const node) : key(key), node(node) {}
-		NodeChild() : key(TOP_NODE) {}
-		NodeChild(std::vector<Node*> &&references) : key(REFERENCES) { new(&this->references) references_t(std::move(references)); }
-		NodeChild(const NodeChild &) = delete;
-		NodeChild& operator=(const NodeChild &) = delete;
-		inline NodeChild(NodeChild &&other);
-		inline NodeChild& operator=(NodeChild &&other);
-		~NodeChild() { deconstructValue(); }
-		
-		value_t getKey() const { return key; }
-		Node& getNode() { return *node; }
-		const Node& getNode() const { return *node; }
-		references_t& getReferences() { return references; }
-		const references_t& getReferences() const { return references; }
+		value_t key;
+		index_t index;  // A node for a normal key, a list of references for `REFERENCES` and nothing for `TOP_NODE`.
 	};
-	class NodeChildren : public std::vector<NodeChild>
+	// Children are kept sorted by their keys, so they can be found by a binary search even in nodes with a wide fan-out.
+	// (The special keys are the greatest values, so they are always at the end.)
+	// A view is valid only until a child is inserted anywhere in the diagram because the pool may move.
+	template<typename CHILD_T>
+	class ChildrenView
 	{
-		using super = std::vector<NodeChild>;
+		CHILD_T *first, *last;
 	public:
-		typename super::iterator find(const value_t &key) { for (typename super::iterator iter = super::begin(); iter != super::end(); ++iter) if (iter->getKey() == key) return iter; return super::end(); }
-		typename super::const_iterator find(const value_t &key) const { return const_cast<NodeChildren*>(this)->find(key); }
-		void erase(const value_t &key) { super::erase(find(key)); }
+		ChildrenView(CHILD_T *const first, CHILD_T *const last) : first(first), last(last) {}
+		CHILD_T* begin() const { return first; }
+		CHILD_T* end() const { return last; }
+		CHILD_T* lowerBound(const value_t &key) const { return std::lower_bound(first, last, key, [](const NodeChild &child, const value_t &key){ return child.key < key; }); }
+		CHILD_T* find(const value_t &key) const { CHILD_T *const iter = lowerBound(key); return iter != last && iter->key == key ? iter : last; }
 	};
+	// The children of a node are a block of `childPool` whose capacity is a power of 2, so an outgrown block can be reused by any node that needs a block of that size.
 	struct Node
 	{
-		NodeChildren children;
+		index_t firstChild, childCount, childCapacity;
 		value_t value;
-		Node *parent;
+		index_t parent;
 	};
-	Node root{{}, 0, nullptr};
+	static constexpr index_t ROOT = 0;
+	
+	std::deque<Node> nodes{Node{0, 0, 0, 0, NO_INDEX}};
+	std::vector<NodeChild> childPool;
+	std::vector<std::vector<index_t>> freeChildBlocks;  // Indexed by the binary logarithm of the capacity.
+	std::deque<references_t> referenceLists;
+	std::vector<index_t> freeNodes, freeReferenceLists;
 	
 	std::size_t size = 0;
 	
 	mutable std::vector<value_t> workingVector;
 	
-	static bool containsSubset(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const Node &currentNode);
+	index_t makeNode(const value_t value, const index_t parent);
+	void freeNode(const index_t node) { freeNodes.push_back(node); }
+	ChildrenView<NodeChild> getChildren(const index_t node) { const Node &n = nodes[node]; return {childPool.data() + n.firstChild, childPool.data() + n.firstChild + n.childCount}; }
+	ChildrenView<const NodeChild> getChildren(const index_t node) const { const Node &n = nodes[node]; return {childPool.data() + n.firstChild, childPool.data() + n.firstChild + n.childCount}; }
+	void growChildren(const index_t node);
+	void insertChild(const index_t node, const NodeChild child);
+	void eraseChild(const index_t node, const value_t key);
+	index_t makeReferences(const index_t reference);
+	void freeReferences(const index_t references) { referenceLists[references].clear(); freeReferenceLists.push_back(references); }
+	index_t findOrMakeChild(const index_t node, const value_t value);
+	
+	bool containsSubset(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode, const std::size_t maxSize) const;
 	
-	Node& insert(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, Node &currentNode);
-	void insertSideBranch(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, Node &currentNode, Node &result);
+	index_t insert(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode);
+	void insertSideBranch(typename set_t::const_iterator currentInSet, const typename set_t::const_iterator &endOfSet, const index_t currentNode, const index_t resultNode);
 	
-	void removeChildren(Node &node);
-	void removeTopNode(Node &topNode);
-	static void removeSideBranch(typename std::vector<value_t>::const_reverse_iterator currentInSet, const typename std::vector<value_t>::const_reverse_iterator &endOfSet, Node &startPoint, const Node *const endNode);
+	void removeChildren(const index_t node);
+	void removeTopNode(const index_t topNode);
+	void removeSideBranch(typename std::vector<value_t>::const_reverse_iterator currentInSet, const typename std::vector<value_t>::const_reverse_iterator &endOfSet, const index_t startPoint, const index_t endNode);
 	
-	void getSets(sets_t &sets, const Node &currentNode) const;
+	void getSets(sets_t &sets, const index_t currentNode) const;
 	
 public:
 	std::size_t getSize() const { return size; }
 	sets_t getSets() const;
+	// Both are safe to call from many threads at once as long as the diagram is not modified.
+	bool containsSubset(const set_t &set) const { return containsSubset(set.cbegin(), set.cend(), ROOT, set.size()); }
+	bool containsProperSubset(const set_t &set) const { return !set.empty() && containsSubset(set.cbegin(), set.cend(), ROOT, set.size() - 1); }
 	
 	bool insertRemovingSupersets(const set_t &set);
 };
-
-
-template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::NodeChild::moveValue(NodeChild &&other)
-{
-	switch (other.key)
-	{
-	case TOP_NODE:
-		break;
-	case REFERENCES:
-		new (&references) references_t(std::move(other.references));
-		other.references.~references_t();
-		break;
-	default:
-		node = other.node;
-	}
-}
-
-template<typename VALUE_T>
-void HasseDiagram<VALUE_T>::NodeChild::deconstructValue()
-{
-	switch (this->key)
-	{
-	case TOP_NODE:
-		break;
-	case REFERENCES:
-		references.~references_t();
-		break;
-	default:
-		delete node;
-	}
-}
-
-template<typename VALUE_T>
-HasseDiagram<VALUE_T>::NodeChild::NodeChild(NodeChild &&other) :
-	key(other.key)
-{
-	moveValue(std::move(other));
-	other.key = TOP_NODE;
-}
-
-template<typename VALUE_T>
-typename HasseDiagram<VALUE_T>::NodeChild& HasseDiagram<VALUE_T>::NodeChild::operator=(NodeChild &&other)
-{
-	deconstructValue();
-	this->key = other.key;
-	moveValue(std::move(other));
-	other.key = TOP_NODE;
-	return *this;
-}
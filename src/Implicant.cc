@@ -31,11 +31,17 @@ Implicant::splitBits_t Implicant::splitBits() const
 Implicant::minterms_t Implicant::findMinterms() const
 {
 	minterms_t minterms;
-	for (Minterm minterm = 0; minterm != ::maxMinterm; ++minterm)
-		if (covers(minterm))
-			minterms.push_back(minterm);
-	if (covers(maxMinterm)) // This is not handled by the loop in case `::maxMinterm` is really the max value of underlying type of `Minterm`.
-		minterms.push_back(maxMinterm);
+	if (isError())
+		return minterms;
+	// Only the free bits are iterated over (in the ascending order) instead of checking every possible minterm.
+	const mask_t freeBits = ~getMask() & static_cast<mask_t>(::maxMinterm);
+	minterms.reserve(std::size_t(1) << (::bits - bitCount));
+	mask_t x = 0;
+	do
+	{
+		minterms.push_back(trueBits | x);
+		x = ((x | ~freeBits) + 1) & freeBits;
+	} while (x != 0);
 	return minterms;
 }
 
@@ -277,3 +283,12 @@ void Implicant::printMath(std::ostream &o, const bool parentheses) const
 	if (needsParentheses)
 		o << ')';
 }
+
+void Implicant::printPla(std::ostream &o) const
+{
+	for (bits_t i = 0; i != ::bits; ++i)
+	{
+		const mask_t mask = 1 << (::bits - i - 1);
+		o << ((trueBits & mask) != 0 ? '1' : ((falseBits & mask) != 0 ? '0' : '-'));
+	}
+}
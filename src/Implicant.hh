@@ -47,11 +47,13 @@ public:
 	Implicant operator|(const Implicant &other) const { Implicant copy = *this; copy |= other; return copy; }
 	Implicant& operator-=(const Implicant &other) { this->trueBits &= ~other.trueBits; this->falseBits &= ~other.falseBits; recalculateBits(); return *this; }
 	Implicant operator-(const Implicant &other) const { Implicant copy = *this; copy -= other; return copy; }
+	Implicant withFlippedBit(const mask_t bitMask) const { return {trueBits ^ bitMask, falseBits ^ bitMask, bitCount}; }
 	Implicant& setBit(const bits_t bit, const bool negated) { const mask_t mask = 1 << (::bits - bit - 1); if (negated) falseBits |= mask; else trueBits |= mask; ++bitCount; return *this; }
 	
 	constexpr bool isError() const { return falseBits != 0 && bitCount == 0; }
 	constexpr mask_t getTrueBits() const { return isError() ? 0 : trueBits; }
 	constexpr mask_t getFalseBits() const { return isError() ? 0 : falseBits; }
+	constexpr mask_t getMask() const { return getTrueBits() | getFalseBits(); }
 	constexpr bits_t getBitCount() const { return bitCount; }
 	bits_t getTrueBitCount() const { return static_cast<bits_t>(std::bitset<::maxBits>(getTrueBits()).count()); }
 	bits_t getFalseBitCount() const { return static_cast<bits_t>(std::bitset<::maxBits>(getFalseBits()).count()); }
@@ -67,4 +69,5 @@ public:
 	void printVhdl(std::ostream &o, const bool parentheses) const;
 	void printCpp(std::ostream &o, const bool parentheses) const;
 	void printMath(std::ostream &o, const bool parentheses) const;
+	void printPla(std::ostream &o) const;
 };
@@ -0,0 +1,43 @@
+#include "./ImplicantHashTable.hh"
+
+
+std::size_t ImplicantHashTable::findSlot(const Implicant &implicant) const
+{
+	std::size_t slot = hash(implicant) & slotMask;
+	while (slots[slot] != EMPTY_SLOT && implicants[slots[slot]] != implicant)
+		slot = (slot + 1) & slotMask;
+	return slot;
+}
+
+void ImplicantHashTable::grow()
+{
+	slots.assign(slots.size() * 2, EMPTY_SLOT);
+	slotMask = slots.size() - 1;
+	for (std::size_t i = 0; i != implicants.size(); ++i)
+		slots[findSlot(implicants[i])] = i;
+}
+
+ImplicantHashTable::ImplicantHashTable(const std::size_t expectedSize)
+{
+	std::size_t slotCount = 16;
+	while (slotCount < expectedSize * 2)
+		slotCount *= 2;
+	slots.assign(slotCount, EMPTY_SLOT);
+	slotMask = slotCount - 1;
+	implicants.reserve(expectedSize);
+}
+
+std::pair<std::size_t, bool> ImplicantHashTable::insert(const Implicant &implicant)
+{
+	std::size_t slot = findSlot(implicant);
+	if (slots[slot] != EMPTY_SLOT)
+		return {slots[slot], false};
+	if ((implicants.size() + 1) * 2 > slots.size())
+	{
+		grow();
+		slot = findSlot(implicant);
+	}
+	slots[slot] = implicants.size();
+	implicants.push_back(implicant);
+	return {implicants.size() - 1, true};
+}
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "Implicant.hh"
+
+
+// An open-addressing hash table of unique implicants, which are also kept in the order of their insertion.
+class ImplicantHashTable
+{
+public:
+	using implicants_t = std::vector<Implicant>;
+	static constexpr std::size_t NOT_FOUND = SIZE_MAX;
+	
+private:
+	static constexpr std::size_t EMPTY_SLOT = SIZE_MAX;
+	
+	implicants_t implicants;
+	std::vector<std::size_t> slots;
+	std::size_t slotMask;
+	
+	[[nodiscard]] static std::size_t hash(const Implicant &implicant) { const std::uint64_t x = ((static_cast<std::uint64_t>(implicant.getTrueBits()) << 32) | implicant.getFalseBits()) * UINT64_C(0x9E3779B97F4A7C15); return static_cast<std::size_t>(x ^ (x >> 32)); }
+	[[nodiscard]] std::size_t findSlot(const Implicant &implicant) const;
+	void grow();
+	
+public:
+	explicit ImplicantHashTable(const std::size_t expectedSize);
+	
+	[[nodiscard]] std::size_t getSize() const { return implicants.size(); }
+	[[nodiscard]] const implicants_t& getImplicants() const { return implicants; }
+	[[nodiscard]] implicants_t releaseImplicants() { slots.clear(); return std::move(implicants); }
+	
+	[[nodiscard]] std::size_t find(const Implicant &implicant) const { return slots[findSlot(implicant)]; }
+	std::pair<std::size_t, bool> insert(const Implicant &implicant);
+};
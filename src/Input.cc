@@ -1,34 +1,35 @@
 #include "./Input.hh"
 
 #include <algorithm>
+#include <cctype>
 #include <iostream>
-#include <regex>
 #include <utility>
 
 
 void Input::trimLine()
 {
 	const auto commentStart = line.find_first_of('#');
-	if (commentStart != std::string::npos)
-		line.erase(std::next(line.begin(), commentStart), line.end());
-    line.erase(line.begin(), std::find_if(line.begin(), line.end(), [](unsigned char ch) { return !std::isspace(ch); }));
-    line.erase(std::find_if(line.rbegin(), line.rend(), [](unsigned char ch) { return !std::isspace(ch); }).base(), line.end());
+	if (commentStart != std::string_view::npos)
+		line.remove_suffix(line.size() - commentStart);
+	while (!line.empty() && std::isspace(static_cast<unsigned char>(line.front())))
+		line.remove_prefix(1);
+	while (!line.empty() && std::isspace(static_cast<unsigned char>(line.back())))
+		line.remove_suffix(1);
 }
 
-void Input::load(Progress *const progress)
+void Input::loadFromStream(Progress *const progress)
 {
-	if (istream.eof())
+	if (istream->eof())
 	{
-		line.clear();
+		line = {};
 		state = State::LOADED;
 		return;
 	}
 	do
 	{
-		std::getline(istream, line);
-		if (istream.eof())
-			break;
-		if (!istream)
+		std::getline(*istream, lineBuffer);
+		line = lineBuffer;
+		if (!*istream && !istream->eof())
 		{
 			if (progress != nullptr)
 				progress->cerr() << "Cannot read from stdin!\n";
@@ -38,7 +39,19 @@ void Input::load(Progress *const progress)
 			return;
 		}
 		trimLine();
-	} while (line.empty());
+	} while (line.empty() && !istream->eof());
+	state = State::LOADED;
+}
+
+void Input::loadFromContents()
+{
+	do
+	{
+		const std::string_view::size_type lineEnd = contents.find('\n');
+		line = contents.substr(0, lineEnd);
+		contents.remove_prefix(lineEnd == std::string_view::npos ? contents.size() : lineEnd + 1);
+		trimLine();
+	} while (line.empty() && !contents.empty());
 	state = State::LOADED;
 }
 
@@ -49,6 +62,23 @@ bool Input::hasError(Progress *const progress)
 	return state == State::ERROR;
 }
 
+std::string_view Input::PartScanner::next()
+{
+	while (position != line.size() && isSeparator(line[position]))
+		++position;
+	const std::string_view::size_type start = position;
+	while (true)
+	{
+		while (position != line.size() && !isSeparator(line[position]))
+			++position;
+		// Ranges (e.g. "4..7") are single parts even though dots are separators.
+		if (position != start && line.compare(position, 2, "..") == 0 && position + 2 != line.size() && !isSeparator(line[position + 2]))
+			position += 2;
+		else
+			break;
+	}
+	return line.substr(start, position - start);
+}
 
 bool Input::isName() const
 {
@@ -57,20 +87,13 @@ bool Input::isName() const
 
 std::vector<std::string> Input::popParts(Progress &progress)
 {
-	state = State::NOT_LOADED;
+	PartScanner partScanner = popPartScanner();
+	const Progress::calcStepCompletion_t calcStepCompletion = [&partScanner = std::as_const(partScanner)](){ return partScanner.getCompletion(); };
 	std::vector<std::string> parts;
-	if (line == "-")
-		return parts;
-	static const std::regex separator("\\s*(?![-_])[[:punct:]]\\s*|\\s+");
-	static const std::sregex_token_iterator rend;
-	std::sregex_token_iterator::value_type match;
-	const Progress::calcStepCompletion_t calcStepCompletion = [&line = std::as_const(line), &match = std::as_const(match)](){ return static_cast<Progress::completion_t>(match.second - line.cbegin()) / static_cast<Progress::completion_t>(line.size()); };
-	for (std::sregex_token_iterator iter(line.cbegin(), line.cend(), separator, -1); iter != rend; ++iter)
+	for (std::string_view part = partScanner.next(); !part.empty(); part = partScanner.next())
 	{
-		match = *iter;
 		progress.substep(calcStepCompletion);
-		if (match.length() != 0)
-			parts.emplace_back(match);
+		parts.emplace_back(part);
 	}
 	return parts;
 }
@@ -1,7 +1,9 @@
 #pragma once
 
+#include <cctype>
 #include <istream>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "Progress.hh"
@@ -16,19 +18,41 @@ class Input
 		ERROR,
 	};
 	
-	std::istream &istream;
-	std::string line;
+	std::istream *const istream;  // `nullptr` when the whole input is already in memory.
+	std::string_view contents;
+	std::string lineBuffer;
+	std::string_view line;
 	State state = State::NOT_LOADED;
 	
 	void trimLine();
-	void load(Progress *const progress);
+	void loadFromStream(Progress *const progress);
+	void loadFromContents();
+	void load(Progress *const progress) { if (istream != nullptr) loadFromStream(progress); else loadFromContents(); }
 	
 public:
-	Input(std::istream &istream) : istream(istream) {}
+	// Splits a line into parts separated by whitespaces and punctuation characters (except "-", "_" and ".." inside a range) without copying them.
+	class PartScanner
+	{
+		const std::string_view line;
+		std::string_view::size_type position = 0;
+		
+		[[nodiscard]] static bool isSeparator(const char c) { return std::isspace(static_cast<unsigned char>(c)) || (std::ispunct(static_cast<unsigned char>(c)) && c != '-' && c != '_'); }
+		
+	public:
+		explicit PartScanner(const std::string_view line) : line(line) {}
+		
+		[[nodiscard]] std::string_view next();
+		[[nodiscard]] Progress::completion_t getCompletion() const { return static_cast<Progress::completion_t>(position) / static_cast<Progress::completion_t>(line.size()); }
+	};
+	
+	explicit Input(std::istream &istream) : istream(&istream) {}
+	explicit Input(const std::string_view contents) : istream(nullptr), contents(contents) {}
 	
 	bool hasError(Progress *const progress = nullptr);
 	bool isEmpty() const { return line.empty(); }
 	bool isName() const;
-	std::string popLine() { state = State::NOT_LOADED; return std::move(line); }
+	bool isDirective() const { return !line.empty() && line.front() == '.'; }
+	[[nodiscard]] std::string_view popLine() { state = State::NOT_LOADED; return line; }
+	[[nodiscard]] PartScanner popPartScanner() { state = State::NOT_LOADED; return PartScanner(line == "-" ? std::string_view() : line); }
 	std::vector<std::string> popParts(Progress &progress);
 };
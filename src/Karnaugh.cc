@@ -1,7 +1,12 @@
 #include "./Karnaugh.hh"
 
+#include <algorithm>
 #include <cassert>
 #include <cctype>
+#include <charconv>
+#include <climits>
+#include <cstdint>
+#include <system_error>
 #include <iostream>
 
 #include "options.hh"
@@ -9,7 +14,7 @@
 #include "utils.hh"
 
 
-std::size_t Karnaugh::nameCount = 0;
+thread_local std::size_t Karnaugh::nameCount = 0;
 
 Karnaugh::grayCode_t Karnaugh::makeGrayCode(const bits_t bitCount)
 {
@@ -60,7 +65,7 @@ void Karnaugh::prettyPrintTable(const Minterms &target, const Minterms &allowed)
 				for (int i = 0; i != hBits; ++i)
 					std::cout << ' ';
 			const Minterm minterm = (x << hBits) | y;
-			std::cout << (target.find(minterm) != target.cend() ? 'T' : (allowed.find(minterm) != allowed.cend() ? '-' : 'F'));
+			std::cout << (target.contains(minterm) ? 'T' : (allowed.contains(minterm) ? '-' : 'F'));
 		}
 		std::cout << '\n';
 	}
@@ -74,54 +79,118 @@ void Karnaugh::prettyPrintTable() const
 
 void Karnaugh::prettyPrintSolution(const Solution &solution)
 {
-	Minterms minterms;
+	std::vector<Minterm> minterms;
 	for (const auto &implicant : solution)
 	{
 		const auto newMinterms = implicant.findMinterms();
-		minterms.insert(newMinterms.cbegin(), newMinterms.end());
+		minterms.insert(minterms.end(), newMinterms.cbegin(), newMinterms.cend());
 	}
-	prettyPrintTable(minterms);
+	prettyPrintTable(Minterms(std::move(minterms)));
 }
 
-bool Karnaugh::loadMinterms(Minterms &minterms, Input &input, Progress &progress) const
+bool Karnaugh::parseMinterm(const std::string_view string, Minterm &minterm)
 {
-	std::vector<std::string> parts;
+	// This mimics the behavior of `std::stoul` which was used here before. (A sign is allowed and only a leading number is taken into account.)
+	std::string_view digits = string;
+	const bool negative = !digits.empty() && digits.front() == '-';
+	if (!digits.empty() && (digits.front() == '+' || digits.front() == '-'))
+		digits.remove_prefix(1);
+	unsigned long n;
+	static_assert(sizeof(unsigned long) * CHAR_BIT >= ::maxBits);
+	const std::errc error = std::from_chars(digits.data(), digits.data() + digits.size(), n).ec;
+	if (error == std::errc::invalid_argument)
 	{
-		const auto infoGuard = progress.addInfo("splitting input line");
-		progress.step(true);
-		parts = input.popParts(progress);
+		Progress::cerr() << '"' << string << "\" is not a number!\n";
+		return false;
 	}
-	
+	if (error == std::errc::result_out_of_range)
+	{
+		Progress::cerr() << '"' << string << "\" is out of range!\n";
+		return false;
+	}
+	if ((negative && n != 0) || n > ::maxMinterm)
+	{
+		Progress::cerr() << '"' << string << "\" is too big!\n";
+		return false;
+	}
+	minterm = static_cast<Minterm>(n);
+	return true;
+}
+
+bool Karnaugh::parseRange(const std::string_view string, const std::string_view::size_type separatorPos, std::vector<Minterm> &minterms, std::vector<Implicant> &cubes)
+{
+	Minterm first, last;
+	if (!parseMinterm(string.substr(0, separatorPos), first) || !parseMinterm(string.substr(separatorPos + 2), last))
+		return false;
+	if (first > last)
 	{
-		const auto infoGuard = progress.addInfo("parsing numbers");
-		progress.step(true);
-		auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(parts.size()));
-		for (const std::string &string : parts)
+		Progress::cerr() << '"' << string << "\" is not a valid range!\n";
+		return false;
+	}
+	// The range is split into the biggest aligned blocks, each of which is a cube. (Blocks of a single minterm are kept as plain minterms.)
+	for (std::uint_fast64_t blockStart = first; blockStart <= last;)
+	{
+		bits_t freeBitCount = 0;
+		while (freeBitCount != ::bits && blockStart % (std::uint_fast64_t(1) << (freeBitCount + 1)) == 0 && blockStart + (std::uint_fast64_t(1) << (freeBitCount + 1)) - 1 <= last)
+			++freeBitCount;
+		if (freeBitCount != 0)
 		{
-			progressStep.substep();
-			try
-			{
-				const unsigned long n = std::stoul(string);
-				static_assert(sizeof(unsigned long) * CHAR_BIT >= ::maxBits);
-				if (n > ::maxMinterm)
-				{
-					Progress::cerr() << '"' << string << "\" is too big!\n";
-					return false;
-				}
-				minterms.insert(n);
-			}
-			catch (std::invalid_argument &)
-			{
-				Progress::cerr() << '"' << string << "\" is not a number!\n";
+			Implicant &cube = cubes.emplace_back(Implicant::all());
+			for (bits_t i = 0; i != ::bits - freeBitCount; ++i)
+				cube.setBit(i, ((blockStart >> (::bits - i - 1)) & 1) == 0);
+		}
+		else
+		{
+			minterms.push_back(static_cast<Minterm>(blockStart));
+		}
+		blockStart += std::uint_fast64_t(1) << freeBitCount;
+	}
+	return true;
+}
+
+bool Karnaugh::isCube(const std::string_view string)
+{
+	return string.size() == ::bits
+		&& string.find('-') != std::string_view::npos
+		&& std::all_of(string.cbegin(), string.cend(), [](const char c){ return c == '0' || c == '1' || c == '-'; });
+}
+
+void Karnaugh::parseCube(const std::string_view string, std::vector<Implicant> &cubes)
+{
+	Implicant &cube = cubes.emplace_back(Implicant::all());
+	for (bits_t i = 0; i != ::bits; ++i)
+		if (string[i] != '-')
+			cube.setBit(i, string[i] == '0');
+}
+
+bool Karnaugh::loadMinterms(Minterms &minterms, Input &input, Progress &progress)
+{
+	const auto infoGuard = progress.addInfo("parsing numbers");
+	progress.step(true);
+	Input::PartScanner partScanner = input.popPartScanner();
+	const Progress::calcStepCompletion_t calcStepCompletion = [&partScanner = std::as_const(partScanner)](){ return partScanner.getCompletion(); };
+	std::vector<Minterm> numbers;
+	std::vector<Implicant> newCubes;
+	for (std::string_view part = partScanner.next(); !part.empty(); part = partScanner.next())
+	{
+		progress.substep(calcStepCompletion);
+		if (const std::string_view::size_type rangeSeparatorPos = part.find(".."); rangeSeparatorPos != std::string_view::npos)
+		{
+			if (!parseRange(part, rangeSeparatorPos, numbers, newCubes))
 				return false;
-			}
-			catch (std::out_of_range &)
-			{
-				Progress::cerr() << '"' << string << "\" is out of range!\n";
+		}
+		else if (isCube(part))
+		{
+			parseCube(part, newCubes);
+		}
+		else
+		{
+			if (!parseMinterm(part, numbers.emplace_back()))
 				return false;
-			}
 		}
 	}
+	minterms = Minterms(std::move(numbers), newCubes);
+	cubes.insert(cubes.end(), newCubes.cbegin(), newCubes.cend());
 	return true;
 }
 
@@ -136,9 +205,9 @@ void Karnaugh::validate(const Solutions &solutions) const
 		for (Minterm i = 0;; ++i)
 		{
 			progress.substep([i = std::as_const(i)](){ return static_cast<Progress::completion_t>(i) / (static_cast<Progress::completion_t>(::maxMinterm) + 1.0); });
-			if (targetMinterms.find(i) != targetMinterms.cend())
+			if (targetMinterms.contains(i))
 				assert(solution.covers(i));
-			else if (allowedMinterms.find(i) == allowedMinterms.cend())
+			else if (!allowedMinterms.contains(i))
 				assert(!solution.covers(i));
 			if (i == ::maxMinterm)
 				break;
@@ -150,7 +219,7 @@ void Karnaugh::validate(const Solutions &solutions) const
 bool Karnaugh::loadData(Input &input)
 {
 	const std::string progressName = "Loading function \"" + functionName + '"';
-	Progress progress(Progress::Stage::LOADING, progressName.c_str(), 5, false, !options::prompt.getValue());
+	Progress progress(Progress::Stage::LOADING, progressName.c_str(), 3, false, !options::prompt.getValue());
 	
 	if (input.hasError(&progress))
 		return false;
@@ -187,21 +256,30 @@ bool Karnaugh::loadData(Input &input)
 	const auto infoGuard = progress.addInfo("checking for conflicts");
 	progress.step(true);
 	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(targetMinterms.size()));
-	for (const Minterm &targetMinterm : targetMinterms)
+	for (const Minterm targetMinterm : targetMinterms)
 	{
 		progressStep.substep();
-		if (allowedMinterms.find(targetMinterm) == allowedMinterms.cend())
-			allowedMinterms.insert(targetMinterm);
-		else
+		if (allowedMinterms.contains(targetMinterm))
 			Progress::cerr() << targetMinterm << " on the \"don't care\" list of \"" << functionName << "\" will be ignored because it is already a minterm!\n";
 	}
+	allowedMinterms.insert(targetMinterms);
 	
 	return true;
 }
 
+void Karnaugh::setData(std::vector<Minterm> &&target, std::vector<Implicant> &&targetCubes, std::vector<Minterm> &&dontCares, std::vector<Implicant> &&dontCareCubes)
+{
+	// Unlike in the text format, a minterm can be both on the list of minterms and on the list of don't-cares. (It is treated as a minterm.)
+	targetMinterms = Minterms(std::move(target), targetCubes);
+	allowedMinterms = Minterms(std::move(dontCares), dontCareCubes);
+	allowedMinterms.insert(targetMinterms);
+	cubes = std::move(targetCubes);
+	cubes.insert(cubes.end(), dontCareCubes.cbegin(), dontCareCubes.cend());
+}
+
 Solutions Karnaugh::solve() const
 {
-	const Solutions solutions = QuineMcCluskey().solve(allowedMinterms, targetMinterms, functionName);
+	const Solutions solutions = QuineMcCluskey().solve(allowedMinterms, targetMinterms, cubes, functionName);
 #ifndef NDEBUG
 	validate(solutions);
 #endif
@@ -1,9 +1,11 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "global.hh"
+#include "Implicant.hh"
 #include "Input.hh"
 #include "Minterm.hh"
 #include "Minterms.hh"
@@ -16,11 +18,12 @@ class Karnaugh
 {
 	using grayCode_t = std::vector<Minterm>;
 	
-	static std::size_t nameCount;
+	static thread_local std::size_t nameCount;
 	
 	bool nameIsCustom = false;
 	std::string functionName;
 	Minterms targetMinterms, allowedMinterms;
+	std::vector<Implicant> cubes;
 	
 	static grayCode_t makeGrayCode(const bits_t bitCount);
 	static void printBits(const Minterm minterm, const bits_t bitCount);
@@ -28,7 +31,11 @@ class Karnaugh
 	void prettyPrintTable() const;
 	static void prettyPrintSolution(const Solution &solution);
 	
-	bool loadMinterms(Minterms &minterms, Input &input, Progress &progress) const;
+	[[nodiscard]] static bool parseMinterm(const std::string_view string, Minterm &minterm);
+	[[nodiscard]] static bool parseRange(const std::string_view string, const std::string_view::size_type separatorPos, std::vector<Minterm> &minterms, std::vector<Implicant> &cubes);
+	[[nodiscard]] static bool isCube(const std::string_view string);
+	static void parseCube(const std::string_view string, std::vector<Implicant> &cubes);
+	bool loadMinterms(Minterms &minterms, Input &input, Progress &progress);
 #ifndef NDEBUG
 	void validate(const Solutions &solutions) const;
 #endif
@@ -38,10 +45,17 @@ public:
 	Karnaugh(Karnaugh &&) = default;
 	Karnaugh& operator=(Karnaugh &&) = default;
 	
+	static void resetNameCount() { nameCount = 0; }
+	
 	bool hasCustomName() const { return nameIsCustom; }
 	const std::string& getFunctionName() const { return functionName; }
+	const Minterms& getTargetMinterms() const { return targetMinterms; }
+	const Minterms& getAllowedMinterms() const { return allowedMinterms; }
 	
 	bool loadData(Input &input);
+	void setCustomName(std::string &&newFunctionName) { nameIsCustom = true; functionName = std::move(newFunctionName); }
+	void setData(std::vector<Minterm> &&target, std::vector<Implicant> &&targetCubes, std::vector<Minterm> &&dontCares, std::vector<Implicant> &&dontCareCubes);  // Cubes are not expanded to minterms.
+	void setData(Minterms &&target, Minterms &&allowed) { targetMinterms = std::move(target); allowedMinterms = std::move(allowed); cubes.clear(); }
 	Solutions solve() const;
 	
 	void printHumanSolution(const Solution &solution) const;
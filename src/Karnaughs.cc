@@ -1,12 +1,21 @@
 #include "./Karnaughs.hh"
 
 #include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <cstdint>
 #include <filesystem>
 #include <iostream>
 #include <limits>
+#include <map>
+#include <optional>
+#include <sstream>
+#include <tuple>
 
 #include "options.hh"
 #include "Progress.hh"
+#include "TimeLimit.hh"
 #include "utils.hh"
 
 
@@ -223,6 +232,92 @@ bool Karnaughs::loadData(Input &input)
 	return true;
 }
 
+bool Karnaughs::loadPlaData(Input &input, const std::size_t outputCount, Names::names_t &&outputNames, const bool dontCaresInOutputs)
+{
+	Progress progress(Progress::Stage::LOADING, "Loading PLA terms", 1, false, !options::prompt.getValue());
+	progress.step();
+	// Fully specified terms are single minterms and the others are kept as cubes.
+	std::vector<std::vector<Minterm>> targets(outputCount), dontCareses(outputCount);
+	std::vector<std::vector<Implicant>> targetCubeses(outputCount), dontCareCubeses(outputCount);
+	std::string row;
+	while (true)
+	{
+		if (input.hasError(&progress))
+			return false;
+		if (input.isEmpty())
+			break;
+		const std::string_view line = input.popLine();
+		if (line == ".e" || line == ".end")
+			break;
+		if (line.front() == '.')
+		{
+			Progress::cerr() << "Unexpected PLA directive \"" << line << "\"!\n";
+			return false;
+		}
+		row.clear();
+		for (const char c : line)
+			if (!std::isspace(static_cast<unsigned char>(c)) && c != '|')
+				row.push_back(c);
+		if (row.size() != ::bits + outputCount || !std::all_of(row.cbegin(), std::next(row.cbegin(), ::bits), [](const char c){ return c == '0' || c == '1' || c == '-'; }) || !std::all_of(std::next(row.cbegin(), ::bits), row.cend(), [](const char c){ return c == '0' || c == '1' || c == '-' || c == '~'; }))
+		{
+			Progress::cerr() << '"' << line << "\" is not a valid PLA term!\n";
+			return false;
+		}
+		Implicant cube = Implicant::all();
+		for (bits_t i = 0; i != ::bits; ++i)
+			if (row[i] != '-')
+				cube.setBit(i, row[i] == '0');
+		const bool isMinterm = cube.getBitCount() == ::bits;
+		for (std::size_t i = 0; i != outputCount; ++i)
+		{
+			const char c = row[::bits + i];
+			const bool isTarget = c == '1';
+			if (!isTarget && !(c == '-' && dontCaresInOutputs))
+				continue;
+			if (isMinterm)
+				(isTarget ? targets : dontCareses)[i].push_back(cube.getTrueBits());
+			else
+				(isTarget ? targetCubeses : dontCareCubeses)[i].push_back(cube);
+		}
+	}
+	karnaughs.reserve(outputCount);
+	for (std::size_t i = 0; i != outputCount; ++i)
+	{
+		Karnaugh &karnaugh = karnaughs.emplace_back();
+		if (!outputNames.empty())
+			karnaugh.setCustomName(std::move(outputNames[i]));
+		karnaugh.setData(std::move(targets[i]), std::move(targetCubeses[i]), std::move(dontCareses[i]), std::move(dontCareCubeses[i]));
+	}
+	return true;
+}
+
+bool Karnaughs::loadBinaryData(BinaryReader &reader)
+{
+	const std::size_t functionCount = reader.readNumber();
+	const std::size_t planeSize = static_cast<std::size_t>(::maxMinterm / 8) + 1;
+	Progress progress(Progress::Stage::LOADING, "Loading truth tables", functionCount, false);
+	karnaughs.reserve(std::min(functionCount, std::size_t(1024)));  // The count is not trusted until the data are read.
+	for (std::size_t i = 0; i != functionCount; ++i)
+	{
+		progress.step();
+		const std::string_view name = reader.readString();
+		const std::string_view targetPlane = reader.readBytes(planeSize);
+		const std::string_view dontCarePlane = reader.readBytes(planeSize);
+		if (reader.hasError())
+			break;
+		Karnaugh &karnaugh = karnaughs.emplace_back();
+		if (!name.empty())
+			karnaugh.setCustomName(std::string(name));
+		karnaugh.setData(Minterms(targetPlane), Minterms(targetPlane, dontCarePlane));
+	}
+	if (reader.hasError() || !reader.isAtEnd())
+	{
+		Progress::cerr() << "The binary input is malformed!\n";
+		return false;
+	}
+	return true;
+}
+
 Karnaughs::solutionses_t Karnaughs::makeSolutionses() const
 {
 	solutionses_t solutionses;
@@ -232,6 +327,55 @@ Karnaughs::solutionses_t Karnaughs::makeSolutionses() const
 	return solutionses;
 }
 
+void Karnaughs::removeNeedlessSolutions(solutionses_t &solutionses)
+{
+	// A solution whose prime implicants include all prime implicants of another solution of the same function can't be better than it no matter what is shared, so it is dropped.
+	// With `--cse-margin`, also solutions that cost more than the margin above the cheapest one of their function are dropped.
+	const std::size_t margin = options::cseMargin.getValue();
+	std::size_t allCount = 0, dominatedCount = 0, outsideMarginCount = 0;
+	for (Solutions &solutions : solutionses)
+	{
+		allCount += solutions.size();
+		if (solutions.size() < 2)
+			continue;
+		std::vector<Solution> sortedSolutions(solutions.cbegin(), solutions.cend());
+		for (Solution &sortedSolution : sortedSolutions)
+			std::sort(sortedSolution.begin(), sortedSolution.end());
+		std::size_t bestGateScore = SIZE_MAX;
+		for (const Solution &solution : solutions)
+			bestGateScore = std::min(bestGateScore, solution.getGateScore());
+		
+		std::vector<bool> isNeedless(solutions.size(), false);
+		for (std::size_t i = 0; i != solutions.size(); ++i)
+		{
+			if (solutions[i].getGateScore() - bestGateScore > margin)
+			{
+				isNeedless[i] = true;
+				++outsideMarginCount;
+				continue;
+			}
+			// Of the equal ones, the first one is kept.
+			const Solution &solution = sortedSolutions[i];
+			for (std::size_t j = 0; j != solutions.size(); ++j)
+			{
+				const Solution &otherSolution = sortedSolutions[j];
+				if (j != i && std::includes(solution.cbegin(), solution.cend(), otherSolution.cbegin(), otherSolution.cend()) && (j < i || otherSolution.size() != solution.size()))
+				{
+					isNeedless[i] = true;
+					++dominatedCount;
+					break;
+				}
+			}
+		}
+		
+		std::size_t i = 0;
+		solutions.erase(std::remove_if(solutions.begin(), solutions.end(), [&isNeedless, &i](const Solution&){ return isNeedless[i++]; }), solutions.end());
+	}
+	
+	if (options::statistics.isRaised())
+		Progress::cerr() << "Filtering of solutions - kept: " << (allCount - dominatedCount - outsideMarginCount) << " of " << allCount << ", dominated: " << dominatedCount << ", outside the margin: " << outsideMarginCount << '\n';
+}
+
 void Karnaughs::findBestNonOptimizedSolutions(const solutionses_t &solutionses)
 {
 	Progress progress(Progress::Stage::OPTIMIZING, "Electing the best solutions", solutionses.size(), true);
@@ -274,43 +418,149 @@ void Karnaughs::findBestOptimizedSolutions(const solutionses_t &solutionses)
 	if (solutionses.empty())
 		return;
 	
-	bestSolutions.resize(solutionses.size());
-	std::size_t bestGateScore = SIZE_MAX;
-	Progress::steps_t steps = 1;
-	if (options::status.getValue())
-		for (const Solutions &solutions : solutionses)
-			steps *= solutions.size();
+	// Combinations of solutions are numbered in the order of nested loops over the functions (the last one changes the fastest).
+	// That makes them the leaves of a depth-first search over the functions, where all combinations that share the solutions of the first `i` functions form one subtree.
+	std::vector<std::uintmax_t> subtreeSizes(solutionses.size() + 1, 1);
+	for (std::size_t i = solutionses.size(); i-- != 0;)
+		subtreeSizes[i] = solutionses[i].size() > UINTMAX_MAX / subtreeSizes[i + 1] ? UINTMAX_MAX : subtreeSizes[i + 1] * solutionses[i].size();
+	const std::uintmax_t combinationCount = subtreeSizes.front();
+	const auto decodeCombination = [&solutionses](std::uintmax_t combination){
+			std::vector<std::size_t> indexes(solutionses.size());
+			for (std::size_t i = solutionses.size(); i-- != 0;)
+			{
+				indexes[i] = static_cast<std::size_t>(combination % solutionses[i].size());
+				combination /= solutionses[i].size();
+			}
+			return indexes;
+		};
+	
+	const Progress::steps_t steps = options::status.getValue() ? combinationCount : 1;
 #ifdef NDEBUG
 	Progress progress(Progress::Stage::OPTIMIZING, "Eliminating common subexpressions", steps, true);
 #else
 	Progress progress(Progress::Stage::OPTIMIZING, "Eliminating common subexpressions", steps * 2, false);
 #endif
-	for (std::vector<std::size_t> indexes(solutionses.size(), 0);;)
+	
+	// Each thread takes the next unchecked combination and remembers the best one it has seen.
+	struct Best
 	{
-		progress.step();
-		std::vector<const Solution*> solutions;
-		solutions.reserve(indexes.size());
-		for (std::size_t i = 0; i != indexes.size(); ++i)
-			solutions.push_back(&solutionses[i][indexes[i]]);
-		OptimizedSolutions currentOSs(solutions, progress);
-		
-		if (currentOSs.getGateScore() < bestGateScore)
+		std::size_t gateScore = SIZE_MAX;
+		std::uintmax_t combination = 0;
+		OptimizedSolutions optimizedSolutions;
+		std::uintmax_t optimizedCombinations = 0, prunedCombinations = 0, prunedSubtrees = 0;
+	};
+	const std::size_t threadCount = static_cast<std::size_t>(std::min<std::uintmax_t>(options::jobs.getValue(), combinationCount));
+	std::vector<Best> bestPerThread(threadCount);
+	std::atomic<std::uintmax_t> nextCombination = 0, finishedCombinations = 0;
+	std::atomic<std::size_t> bestGateScore = SIZE_MAX;
+	// Different combinations often give the same sets to optimize, so all threads share their results.
+	const std::size_t cacheSize = options::cseCacheSize.getValue();
+	std::optional<OptimizedSolutions::Caches> caches;
+	if (cacheSize != 0 && combinationCount > 1)
+		caches.emplace(cacheSize);
+	OptimizedSolutions::Caches *const sharedCaches = caches ? &*caches : nullptr;
+	runInParallel(threadCount, [&solutionses, &subtreeSizes, combinationCount, &decodeCombination, &progress, &bestPerThread, &nextCombination, &finishedCombinations, &bestGateScore, sharedCaches](const std::size_t threadIndex){
+			// Only the calling thread shows progress. It counts also the combinations that were checked or skipped by the other threads.
+			std::optional<Progress> threadProgress;
+			if (threadIndex != 0)
+				threadProgress.emplace(Progress::Stage::OPTIMIZING, "Eliminating common subexpressions", 1, true, false);
+			Progress &currentProgress = threadIndex == 0 ? progress : *threadProgress;
+			Progress::steps_t stepsSoFar = 0;
+			Best &best = bestPerThread[threadIndex];
+			std::vector<const Solution*> solutions;
+			solutions.reserve(solutionses.size());
+			for (std::uintmax_t combination = nextCombination++; combination < combinationCount; combination = nextCombination++)
+			{
+				if (threadIndex == 0)
+				{
+					if (const std::uintmax_t finished = finishedCombinations.load(std::memory_order_relaxed); stepsSoFar <= finished)
+					{
+						progress.skipSteps(finished - stepsSoFar);
+						progress.step();
+						stepsSoFar = finished + 1;
+					}
+				}
+				
+				// The functions are fixed one by one. If even the lower bound of the ones fixed so far is worse than the best score, none of the combinations in their subtree can win.
+				// (Equal scores are not pruned, so that the lowest combination among the best ones is always found, no matter how the threads interleave.)
+				const std::vector<std::size_t> indexes = decodeCombination(combination);
+				solutions.clear();
+				std::size_t prunedDepth = 0;
+				for (std::size_t i = 0; i != indexes.size(); ++i)
+				{
+					solutions.push_back(&solutionses[i][indexes[i]]);
+					if (OptimizedSolutions::calcGateScoreLowerBound(solutions) > bestGateScore.load(std::memory_order_relaxed))
+					{
+						prunedDepth = i + 1;
+						break;
+					}
+				}
+				if (prunedDepth != 0)
+				{
+					const std::uintmax_t subtreeSize = subtreeSizes[prunedDepth];
+					const std::uintmax_t subtreeStart = combination - combination % subtreeSize;
+					const std::uintmax_t subtreeEnd = subtreeSize > combinationCount - subtreeStart ? combinationCount : subtreeStart + subtreeSize;
+					std::uintmax_t next = nextCombination.load(std::memory_order_relaxed);
+					while (next < subtreeEnd && !nextCombination.compare_exchange_weak(next, subtreeEnd, std::memory_order_relaxed)) {}
+					const std::uintmax_t skipped = 1 + (next < subtreeEnd ? subtreeEnd - next : 0);
+					finishedCombinations.fetch_add(skipped, std::memory_order_relaxed);
+					best.prunedCombinations += skipped;
+					++best.prunedSubtrees;
+					continue;
+				}
+				
+				OptimizedSolutions currentOSs(solutions, currentProgress, sharedCaches);
+				finishedCombinations.fetch_add(1, std::memory_order_relaxed);
+				++best.optimizedCombinations;
+				assert(OptimizedSolutions::calcGateScoreLowerBound(solutions) <= currentOSs.getGateScore());
+				
+				if (currentOSs.getGateScore() < best.gateScore)
+				{
+					best.gateScore = currentOSs.getGateScore();
+					best.combination = combination;
+					best.optimizedSolutions = std::move(currentOSs);
+					for (std::size_t bestSoFar = bestGateScore.load(std::memory_order_relaxed); best.gateScore < bestSoFar && !bestGateScore.compare_exchange_weak(bestSoFar, best.gateScore, std::memory_order_relaxed);) {}
+				}
+				if (TimeLimit::isUp())
+					break;
+			}
+		});
+	
+	if (options::statistics.isRaised())
+	{
+		std::uintmax_t optimizedCombinations = 0, prunedCombinations = 0, prunedSubtrees = 0;
+		for (const Best &best : bestPerThread)
 		{
-			bestGateScore = currentOSs.getGateScore();
-			for (std::size_t i = 0; i != indexes.size(); ++i)
-				bestSolutions[i] = solutionses[i][indexes[i]];
-			optimizedSolutions = std::move(currentOSs);
+			optimizedCombinations += best.optimizedCombinations;
+			prunedCombinations += best.prunedCombinations;
+			prunedSubtrees += best.prunedSubtrees;
 		}
-		
-		for (std::size_t i = indexes.size() - 1;; --i)
+		Progress::cerr() << "Elimination of common subexpressions - combinations: " << combinationCount << ", optimized: " << optimizedCombinations << ", pruned: " << prunedCombinations << " (in " << prunedSubtrees << " subtrees)\n";
+		if (caches)
 		{
-			if (++indexes[i] != solutionses[i].size())
-				break;
-			indexes[i] = 0;
-			if (i == 0)
-				return;
+			caches->products.printStatistics("products");
+			caches->sums.printStatistics("sums");
 		}
 	}
+	
+	// Each thread checks its combinations in increasing order, so taking the lowest one among the equally good ones gives the same result as checking them one by one.
+	Best &best = *std::min_element(bestPerThread.begin(), bestPerThread.end(), [](const Best &x, const Best &y){ return std::tie(x.gateScore, x.combination) < std::tie(y.gateScore, y.combination); });
+	const std::vector<std::size_t> indexes = decodeCombination(best.combination);
+	bestSolutions.resize(solutionses.size());
+	for (std::size_t i = 0; i != indexes.size(); ++i)
+		bestSolutions[i] = solutionses[i][indexes[i]];
+	optimizedSolutions = std::move(best.optimizedSolutions);
+	if (caches)
+	{
+		// The cached results list the parts in their own order, so the best combination is optimized once more to keep the output the same as without the caches.
+		// (It can be worse only when the time limit cut it short.)
+		std::vector<const Solution*> solutions;
+		for (const Solution &solution : bestSolutions)
+			solutions.push_back(&solution);
+		OptimizedSolutions uncachedOptimizedSolutions(solutions, progress);
+		if (uncachedOptimizedSolutions.getGateScore() <= optimizedSolutions.getGateScore())
+			optimizedSolutions = std::move(uncachedOptimizedSolutions);
+	}
 }
 
 void Karnaughs::findBestSolutions(const solutionses_t &solutionses)
@@ -323,7 +573,9 @@ void Karnaughs::findBestSolutions(const solutionses_t &solutionses)
 
 void Karnaughs::solve()
 {
-	const std::vector<Solutions> solutionses = makeSolutionses();
+	solutionses_t solutionses = makeSolutionses();
+	if (!options::skipOptimization.isRaised())
+		removeNeedlessSolutions(solutionses);
 	findBestSolutions(solutionses);
 }
 
@@ -535,6 +787,96 @@ void Karnaughs::printGateCost()
 	}
 }
 
+void Karnaughs::printPla()
+{
+	// Products shared by several functions are put in a single term.
+	std::vector<std::pair<Implicant, std::string>> terms;
+	std::map<Implicant, std::size_t> termIndexes;
+	for (std::size_t i = 0; i != bestSolutions.size(); ++i)
+	{
+		Solution sortedSolution = bestSolutions[i];
+		for (const Implicant &implicant : sortedSolution.sort())
+		{
+			if (implicant.isError())
+				continue;
+			const auto [iter, inserted] = termIndexes.try_emplace(implicant, terms.size());
+			if (inserted)
+				terms.emplace_back(implicant, std::string(bestSolutions.size(), '0'));
+			terms[iter->second].second[i] = '1';
+		}
+	}
+	
+	std::cout << ".i " << static_cast<unsigned>(::bits) << '\n';
+	std::cout << ".o " << karnaughs.size() << '\n';
+	if (::bits != 0)
+	{
+		std::cout << ".ilb";
+		for (std::size_t i = 0; i != ::bits; ++i)
+		{
+			std::cout << ' ';
+			::inputNames.printPlaName(std::cout, i);
+		}
+		std::cout << '\n';
+	}
+	if (!karnaughs.empty())
+	{
+		const Names functionNames = gatherFunctionNames();
+		std::cout << ".ob";
+		for (std::size_t i = 0; i != karnaughs.size(); ++i)
+		{
+			std::cout << ' ';
+			functionNames.printPlaName(std::cout, i);
+		}
+		std::cout << '\n';
+	}
+	std::cout << ".p " << terms.size() << '\n';
+	for (const auto &[implicant, outputs] : terms)
+	{
+		implicant.printPla(std::cout);
+		std::cout << ' ' << outputs << '\n';
+	}
+	std::cout << ".e" << std::endl;
+}
+
+void Karnaughs::printBinary() const
+{
+	// Layout of the format (numbers are 32-bit little endian, strings are prefixed by their length):
+	// - `BinaryReader::MAGIC`
+	// - the number of inputs (1 byte) and whether they have names (1 byte), followed by the names if they do
+	// - the number of functions
+	// - for each function: its name (empty for a default one), the bit-plane of minterms and the bit-plane of don't-cares
+	// Bit-planes have `2^inputs / 8` bytes (at least 1) and minterm N is the bit `N % 8` (LSB first) of the byte `N / 8`.
+	std::string output(BinaryReader::MAGIC);
+	output.push_back(static_cast<char>(::bits));
+	output.push_back(static_cast<char>(::inputNames.areNamesUsedInCode()));
+	std::ostringstream name;
+	if (::inputNames.areNamesUsedInCode())
+	{
+		for (std::size_t i = 0; i != ::bits; ++i)
+		{
+			name.str({});
+			::inputNames.printHumanName(name, i);
+			BinaryReader::writeString(output, name.str());
+		}
+	}
+	BinaryReader::writeNumber(output, static_cast<std::uint32_t>(karnaughs.size()));
+	const std::size_t planeSize = static_cast<std::size_t>(::maxMinterm / 8) + 1;
+	for (const Karnaugh &karnaugh : karnaughs)
+	{
+		BinaryReader::writeString(output, karnaugh.hasCustomName() ? karnaugh.getFunctionName() : std::string_view());
+		const std::string::size_type targetPlaneOffset = output.size(), dontCarePlaneOffset = targetPlaneOffset + planeSize;
+		output.resize(output.size() + 2 * planeSize, '\0');
+		for (const Minterm minterm : karnaugh.getTargetMinterms())
+			output[targetPlaneOffset + minterm / 8] |= static_cast<char>(1u << (minterm % 8));
+		for (const Minterm minterm : karnaugh.getAllowedMinterms())
+			output[dontCarePlaneOffset + minterm / 8] |= static_cast<char>(1u << (minterm % 8));
+		for (std::size_t i = 0; i != planeSize; ++i)  // Minterms are always allowed, so removing them leaves only don't-cares.
+			output[dontCarePlaneOffset + i] ^= output[targetPlaneOffset + i];
+	}
+	std::cout.write(output.data(), static_cast<std::streamsize>(output.size()));
+	std::cout.flush();
+}
+
 void Karnaughs::print()
 {
 	switch (options::outputFormat.getValue())
@@ -566,5 +908,8 @@ void Karnaughs::print()
 	case options::OutputFormat::GATE_COSTS:
 		printGateCost();
 		break;
+	case options::OutputFormat::PLA:
+		printPla();
+		break;
 	}
 }
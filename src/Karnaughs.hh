@@ -5,6 +5,7 @@
 #include <utility>
 #include <vector>
 
+#include "BinaryReader.hh"
 #include "Solution.hh"
 #include "Input.hh"
 #include "Names.hh"
@@ -42,12 +43,15 @@ class Karnaughs
 	[[nodiscard]] bool areInputsUsed() const;
 	
 	solutionses_t makeSolutionses() const;
+	static void removeNeedlessSolutions(solutionses_t &solutionses);
 	void findBestNonOptimizedSolutions(const solutionses_t &solutionses);
 	void findBestOptimizedSolutions(const solutionses_t &solutionses);
 	void findBestSolutions(const solutionses_t &solutionses);
 	
 public:
 	[[nodiscard]] bool loadData(Input &input);
+	[[nodiscard]] bool loadPlaData(Input &input, const std::size_t outputCount, Names::names_t &&outputNames, const bool dontCaresInOutputs);
+	[[nodiscard]] bool loadBinaryData(BinaryReader &reader);
 	
 	void solve();
 	void printHuman();
@@ -57,5 +61,7 @@ public:
 	void printCpp();
 	void printMath();
 	void printGateCost();
+	void printPla();
+	void printBinary() const;
 	void print();
 };
@@ -0,0 +1,163 @@
+#include "./MinimalCoverSearch.hh"
+
+#include <algorithm>
+#include <bitset>
+#include <cstdint>
+#include <iterator>
+
+#include "global.hh"
+#include "TimeLimit.hh"
+
+
+template<typename INDEX_T>
+MinimalCoverSearch<INDEX_T>::MinimalCoverSearch(const std::vector<Implicant> &primeImplicants, const rows_t &rows, const cost_t slack, Progress &progress) :
+	primeImplicants(primeImplicants),
+	rows(rows),
+	slack(slack),
+	progress(progress),
+	primeRows(primeImplicants.size()),
+	coverCounts(rows.size(), 0),
+	forbidden(primeImplicants.size(), false),
+	excluded(rows.size(), false)
+{
+	primeCosts.reserve(primeImplicants.size());
+	for (const Implicant &primeImplicant : primeImplicants)
+		primeCosts.push_back(primeImplicant.getBitCount() * cost_t(2));
+	for (std::size_t row = 0; row != rows.size(); ++row)
+		for (const index_t prime : rows[row])
+			primeRows[prime].push_back(row);
+}
+
+template<typename INDEX_T>
+typename MinimalCoverSearch<INDEX_T>::cost_t MinimalCoverSearch<INDEX_T>::calcLowerBound()
+{
+	// Uncovered rows that have no usable prime implicant in common need different prime implicants, so the sum of their cheapest options is a lower bound.
+	// (Negations are not included because they can be shared.)
+	std::fill(excluded.begin(), excluded.end(), false);
+	cost_t lowerBound = 0;
+	for (std::size_t row = 0; row != rows.size(); ++row)
+	{
+		if (coverCounts[row] != 0 || excluded[row])
+			continue;
+		cost_t cheapest = INFINITE_COST;
+		for (const index_t prime : rows[row])
+		{
+			if (forbidden[prime])
+				continue;
+			cheapest = std::min(cheapest, primeCosts[prime]);
+			for (const std::size_t otherRow : primeRows[prime])
+				excluded[otherRow] = true;
+		}
+		if (cheapest == INFINITE_COST)
+			return INFINITE_COST;
+		lowerBound += cheapest;
+	}
+	return lowerBound;
+}
+
+template<typename INDEX_T>
+std::size_t MinimalCoverSearch<INDEX_T>::findBranchingRow() const
+{
+	// The row with the fewest options gives the smallest number of branches.
+	std::size_t bestRow = SIZE_MAX, bestOptionCount = SIZE_MAX;
+	for (std::size_t row = 0; row != rows.size(); ++row)
+	{
+		if (coverCounts[row] != 0)
+			continue;
+		const std::size_t optionCount = static_cast<std::size_t>(std::count_if(rows[row].cbegin(), rows[row].cend(), [this](const index_t prime){ return !forbidden[prime]; }));
+		if (optionCount < bestOptionCount)
+		{
+			bestRow = row;
+			bestOptionCount = optionCount;
+		}
+	}
+	return bestRow;
+}
+
+template<typename INDEX_T>
+bool MinimalCoverSearch<INDEX_T>::isChosenIrredundant() const
+{
+	return std::all_of(chosen.cbegin(), chosen.cend(), [this](const index_t prime){
+			return std::any_of(primeRows[prime].cbegin(), primeRows[prime].cend(), [this](const std::size_t row){ return coverCounts[row] == 1; });
+		});
+}
+
+template<typename INDEX_T>
+void MinimalCoverSearch<INDEX_T>::choose(const index_t prime)
+{
+	chosen.push_back(prime);
+	for (const std::size_t row : primeRows[prime])
+		++coverCounts[row];
+}
+
+template<typename INDEX_T>
+void MinimalCoverSearch<INDEX_T>::unchoose(const index_t prime)
+{
+	chosen.pop_back();
+	for (const std::size_t row : primeRows[prime])
+		--coverCounts[row];
+}
+
+template<typename INDEX_T>
+void MinimalCoverSearch<INDEX_T>::search(const cost_t cost, const Implicant::mask_t falseBits, const bool topLevel)
+{
+	progress.substep([this](){ return completion; });
+	// When the time is up, the search stops as soon as it has at least one cover.
+	if (bestCost != INFINITE_COST && TimeLimit::isUp())
+		return;
+	const cost_t currentCost = cost + std::bitset<::maxBits>(falseBits).count();
+	const cost_t lowerBound = calcLowerBound();
+	if (lowerBound == INFINITE_COST || (bestCost != INFINITE_COST && currentCost + lowerBound > bestCost + slack))
+		return;
+	
+	const std::size_t row = findBranchingRow();
+	if (row == SIZE_MAX)
+	{
+		// A redundant cover is never needed because removing the redundant prime implicant gives a cheaper one.
+		if (isChosenIrredundant())
+		{
+			product_t &cover = found.emplace_back(currentCost, chosen).second;
+			std::sort(cover.begin(), cover.end());
+			bestCost = std::min(bestCost, currentCost);
+		}
+		return;
+	}
+	
+	std::vector<index_t> options;
+	std::copy_if(rows[row].cbegin(), rows[row].cend(), std::back_inserter(options), [this](const index_t prime){ return !forbidden[prime]; });
+	std::stable_sort(options.begin(), options.end(), [this](const index_t x, const index_t y){ return primeCosts[x] < primeCosts[y]; });
+	for (std::size_t i = 0; i != options.size(); ++i)
+	{
+		const index_t prime = options[i];
+		choose(prime);
+		search(cost + primeCosts[prime], falseBits | primeImplicants[prime].getFalseBits(), false);
+		unchoose(prime);
+		// Every cover that contains this prime implicant has been already found, so the next branches don't need to look at it again.
+		forbidden[prime] = true;
+		if (topLevel)
+			completion = static_cast<Progress::completion_t>(i + 1) / static_cast<Progress::completion_t>(options.size());
+	}
+	for (const index_t prime : options)
+		forbidden[prime] = false;
+}
+
+template<typename INDEX_T>
+typename MinimalCoverSearch<INDEX_T>::sumOfProducts_t MinimalCoverSearch<INDEX_T>::find(const Implicant::mask_t initialFalseBits)
+{
+	search(0, initialFalseBits, true);
+	
+	std::sort(found.begin(), found.end());
+	sumOfProducts_t covers;
+	for (auto &[cost, cover] : found)
+	{
+		if (cost > bestCost + slack)
+			break;
+		covers.push_back(std::move(cover));
+	}
+	return covers;
+}
+
+
+template class MinimalCoverSearch<std::uint8_t>;
+template class MinimalCoverSearch<std::uint16_t>;
+template class MinimalCoverSearch<std::uint32_t>;
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+#include "Implicant.hh"
+#include "Progress.hh"
+
+
+// A branch-and-bound search for the cheapest covers of minterms by prime implicants.
+// Unlike Petrick's method, it doesn't create every irredundant cover but only the ones that cost at most `slack` more than the best one.
+// The cost is the same as the one used to elect the best solution: 2 for each input of each product and 1 for each negated input.
+template<typename INDEX_T>
+class MinimalCoverSearch
+{
+public:
+	using index_t = INDEX_T;
+	using product_t = std::vector<index_t>;
+	using sumOfProducts_t = std::vector<product_t>;
+	using rows_t = std::vector<std::vector<index_t>>;  // For each minterm, the indices of prime implicants that cover it.
+	using cost_t = std::size_t;
+	
+private:
+	static constexpr cost_t INFINITE_COST = static_cast<cost_t>(~cost_t(0));
+	
+	const std::vector<Implicant> &primeImplicants;
+	const rows_t &rows;
+	const cost_t slack;
+	Progress &progress;
+	
+	std::vector<cost_t> primeCosts;
+	std::vector<std::vector<std::size_t>> primeRows;  // For each prime implicant, the rows that it covers.
+	std::vector<std::size_t> coverCounts;  // For each row, the number of chosen prime implicants that cover it.
+	std::vector<bool> forbidden;  // Prime implicants that were already tried in a sibling branch.
+	std::vector<bool> excluded;  // Rows that cannot be a part of the current independent set. (Only a buffer for `calcLowerBound`.)
+	product_t chosen;
+	std::vector<std::pair<cost_t, product_t>> found;
+	cost_t bestCost = INFINITE_COST;
+	Progress::completion_t completion = 0.0;
+	
+	[[nodiscard]] cost_t calcLowerBound();
+	[[nodiscard]] std::size_t findBranchingRow() const;
+	[[nodiscard]] bool isChosenIrredundant() const;
+	void choose(const index_t prime);
+	void unchoose(const index_t prime);
+	void search(const cost_t cost, const Implicant::mask_t falseBits, const bool topLevel);
+	
+public:
+	MinimalCoverSearch(const std::vector<Implicant> &primeImplicants, const rows_t &rows, const cost_t slack, Progress &progress);
+	
+	[[nodiscard]] sumOfProducts_t find(const Implicant::mask_t initialFalseBits);
+};
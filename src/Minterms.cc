@@ -0,0 +1,265 @@
+#include "./Minterms.hh"
+
+#include <algorithm>
+#include <bitset>
+#include <climits>
+
+#include "global.hh"
+
+
+bool Minterms::shouldBeDense(const std::uint64_t size)
+{
+	// The bitmap is used when it takes less memory than the vector.
+	return size * (sizeof(Minterm) * CHAR_BIT) >= static_cast<std::uint64_t>(::maxMinterm) + 1;
+}
+
+Minterms::word_t Minterms::makeCubePattern(const Implicant &cube)
+{
+	// The free bits below the size of a word make the same pattern in every word that the cube touches.
+	const std::uint64_t fixedBits = cube.getMask(), trueBits = cube.getTrueBits();
+	word_t pattern = 0;
+	for (std::uint64_t bit = 0; bit != WORD_BITS && bit <= ::maxMinterm; ++bit)
+		if ((bit & fixedBits) == (trueBits % WORD_BITS))
+			pattern |= word_t(1) << bit;
+	return pattern;
+}
+
+Minterms::position_t Minterms::findValidPosition(position_t position) const
+{
+	if (dense)
+	{
+		std::size_t wordIndex = static_cast<std::size_t>(position / WORD_BITS);
+		if (wordIndex >= bitmap.size())
+			return getEndPosition();
+		word_t word = bitmap[wordIndex] & (~word_t(0) << (position % WORD_BITS));
+		while (word == 0)
+		{
+			if (++wordIndex == bitmap.size())
+				return getEndPosition();
+			word = bitmap[wordIndex];
+		}
+		const std::size_t trailingZeros = std::bitset<WORD_BITS>((word & (~word + 1)) - 1).count();
+		return static_cast<position_t>(wordIndex) * WORD_BITS + trailingZeros;
+	}
+	else
+	{
+		if (!erased.empty())
+			while (position < sortedMinterms.size() && erased[static_cast<std::size_t>(position)])
+				++position;
+		return position;
+	}
+}
+
+Minterms::Minterms(std::vector<Minterm> &&minterms) :
+	dense(shouldBeDense(minterms.size()))
+{
+	if (dense)
+	{
+		bitmap.assign(static_cast<std::size_t>(::maxMinterm / WORD_BITS) + 1, 0);
+		for (const Minterm minterm : minterms)
+			bitmap[minterm / WORD_BITS] |= word_t(1) << (minterm % WORD_BITS);
+		recount();
+	}
+	else
+	{
+		std::sort(minterms.begin(), minterms.end());
+		minterms.erase(std::unique(minterms.begin(), minterms.end()), minterms.end());
+		count = minterms.size();
+		sortedMinterms = std::move(minterms);
+	}
+}
+
+Minterms::Minterms(std::vector<Minterm> &&minterms, const std::vector<Implicant> &cubes)
+{
+	std::uint64_t maxCount = minterms.size();
+	for (const Implicant &cube : cubes)
+		maxCount += std::uint64_t(1) << (::bits - cube.getBitCount());
+	if (!shouldBeDense(maxCount))
+	{
+		// The result is small, so expanding the cubes costs no more than the vector itself.
+		for (const Implicant &cube : cubes)
+		{
+			const Implicant::minterms_t cubeMinterms = cube.findMinterms();
+			minterms.insert(minterms.end(), cubeMinterms.cbegin(), cubeMinterms.cend());
+		}
+		*this = Minterms(std::move(minterms));
+		return;
+	}
+	
+	dense = true;
+	bitmap.assign(static_cast<std::size_t>(::maxMinterm / WORD_BITS) + 1, 0);
+	for (const Minterm minterm : minterms)
+		bitmap[minterm / WORD_BITS] |= word_t(1) << (minterm % WORD_BITS);
+	for (const Implicant &cube : cubes)
+	{
+		// The free bits above the size of a word choose the words, which are enumerated the same way as minterms in `Implicant::findMinterms`.
+		const word_t pattern = makeCubePattern(cube);
+		const std::uint64_t wordFreeBits = (~std::uint64_t(cube.getMask()) & ::maxMinterm) / WORD_BITS, wordTrueBits = cube.getTrueBits() / WORD_BITS;
+		std::uint64_t x = 0;
+		do
+		{
+			bitmap[static_cast<std::size_t>(wordTrueBits | x)] |= pattern;
+			x = ((x | ~wordFreeBits) + 1) & wordFreeBits;
+		} while (x != 0);
+	}
+	recount();
+	// Cubes may overlap, so the result may still be small enough for the vector.
+	if (!shouldBeDense(count))
+		*this = Minterms(std::vector<Minterm>(cbegin(), cend()));
+}
+
+Minterms::Minterms(const std::string_view bitPlane, const std::string_view otherBitPlane)
+{
+	const std::size_t byteCount = static_cast<std::size_t>(::maxMinterm / CHAR_BIT) + 1;
+	const unsigned lastByteMask = (1u << (::maxMinterm % CHAR_BIT + 1)) - 1;  // Functions with less than 3 inputs don't fill the whole byte.
+	const auto getByte = [&bitPlane, &otherBitPlane, byteCount, lastByteMask](const std::size_t i)
+		{
+			const unsigned byte = static_cast<unsigned char>(bitPlane[i]) | (otherBitPlane.empty() ? 0u : static_cast<unsigned char>(otherBitPlane[i]));
+			return i + 1 == byteCount ? byte & lastByteMask : byte;
+		};
+	
+	for (std::size_t i = 0; i != byteCount; ++i)
+		count += std::bitset<CHAR_BIT>(getByte(i)).count();
+	dense = shouldBeDense(count);
+	if (dense)
+	{
+		// The bitmap has the same layout as the bit-planes, so bytes only need to be put together into words.
+		bitmap.assign(static_cast<std::size_t>(::maxMinterm / WORD_BITS) + 1, 0);
+		for (std::size_t i = 0; i != byteCount; ++i)
+			bitmap[i / sizeof(word_t)] |= static_cast<word_t>(getByte(i)) << (i % sizeof(word_t) * CHAR_BIT);
+	}
+	else
+	{
+		sortedMinterms.reserve(count);
+		for (std::size_t i = 0; i != byteCount; ++i)
+			for (unsigned byte = getByte(i), bit = 0; byte != 0; byte >>= 1, ++bit)
+				if ((byte & 1) != 0)
+					sortedMinterms.push_back(static_cast<Minterm>(i * CHAR_BIT + bit));
+	}
+}
+
+bool Minterms::contains(const Minterm minterm) const
+{
+	if (dense)
+	{
+		return minterm <= ::maxMinterm && (bitmap[minterm / WORD_BITS] & (word_t(1) << (minterm % WORD_BITS))) != 0;
+	}
+	else
+	{
+		const auto iter = std::lower_bound(sortedMinterms.cbegin(), sortedMinterms.cend(), minterm);
+		return iter != sortedMinterms.cend() && *iter == minterm && (erased.empty() || !erased[static_cast<std::size_t>(iter - sortedMinterms.cbegin())]);
+	}
+}
+
+bool Minterms::intersects(const Implicant &cube) const
+{
+	if (dense)
+	{
+		const word_t pattern = makeCubePattern(cube);
+		const std::uint64_t wordFreeBits = (~std::uint64_t(cube.getMask()) & ::maxMinterm) / WORD_BITS, wordTrueBits = cube.getTrueBits() / WORD_BITS;
+		std::uint64_t x = 0;
+		do
+		{
+			if ((bitmap[static_cast<std::size_t>(wordTrueBits | x)] & pattern) != 0)
+				return true;
+			x = ((x | ~wordFreeBits) + 1) & wordFreeBits;
+		} while (x != 0);
+		return false;
+	}
+	else
+	{
+		return std::any_of(cbegin(), cend(), [&cube](const Minterm minterm){ return cube.covers(minterm); });
+	}
+}
+
+Minterms::const_iterator Minterms::erase(const_iterator iter)
+{
+	if (dense)
+	{
+		bitmap[static_cast<std::size_t>(iter.position / WORD_BITS)] &= ~(word_t(1) << (iter.position % WORD_BITS));
+	}
+	else
+	{
+		if (erased.empty())
+			erased.resize(sortedMinterms.size(), false);
+		erased[static_cast<std::size_t>(iter.position)] = true;
+	}
+	--count;
+	return ++iter;
+}
+
+bool Minterms::erase(const Minterm minterm)
+{
+	if (dense)
+	{
+		if (!contains(minterm))
+			return false;
+		bitmap[minterm / WORD_BITS] &= ~(word_t(1) << (minterm % WORD_BITS));
+	}
+	else
+	{
+		const auto iter = std::lower_bound(sortedMinterms.cbegin(), sortedMinterms.cend(), minterm);
+		if (iter == sortedMinterms.cend() || *iter != minterm)
+			return false;
+		const std::size_t index = static_cast<std::size_t>(iter - sortedMinterms.cbegin());
+		if (erased.empty())
+			erased.resize(sortedMinterms.size(), false);
+		else if (erased[index])
+			return false;
+		erased[index] = true;
+	}
+	--count;
+	return true;
+}
+
+void Minterms::makeDense()
+{
+	std::vector<word_t> newBitmap(static_cast<std::size_t>(::maxMinterm / WORD_BITS) + 1, 0);
+	for (const Minterm minterm : *this)
+		newBitmap[minterm / WORD_BITS] |= word_t(1) << (minterm % WORD_BITS);
+	dense = true;
+	sortedMinterms.clear();
+	sortedMinterms.shrink_to_fit();
+	erased.clear();
+	bitmap = std::move(newBitmap);
+}
+
+void Minterms::recount()
+{
+	count = 0;
+	for (const word_t word : bitmap)
+		count += std::bitset<WORD_BITS>(word).count();
+}
+
+void Minterms::insert(const Minterms &other)
+{
+	if (other.dense)
+	{
+		// Both bitmaps have the same layout, so they are merged a word at a time.
+		if (!dense)
+			makeDense();
+		for (std::size_t i = 0; i != bitmap.size(); ++i)
+			bitmap[i] |= other.bitmap[i];
+		recount();
+	}
+	else if (dense)
+	{
+		for (const Minterm minterm : other)
+		{
+			word_t &word = bitmap[minterm / WORD_BITS];
+			const word_t bit = word_t(1) << (minterm % WORD_BITS);
+			if ((word & bit) == 0)
+			{
+				word |= bit;
+				++count;
+			}
+		}
+	}
+	else
+	{
+		std::vector<Minterm> merged;
+		merged.reserve(this->size() + other.size());
+		std::merge(this->cbegin(), this->cend(), other.cbegin(), other.cend(), std::back_inserter(merged));
+		*this = Minterms(std::move(merged));
+	}
+}
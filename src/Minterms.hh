@@ -1,8 +1,76 @@
 #pragma once
 
-#include <set>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <string_view>
+#include <vector>
 
+#include "Implicant.hh"
 #include "Minterm.hh"
 
 
-using Minterms = std::set<Minterm>;
+// A set of minterms that is stored either as a sorted vector (when there are few of them) or as a bitmap (when they are dense).
+// Erasing doesn't invalidate iterators. (In the sparse mode, erased elements are only marked as such.)
+class Minterms
+{
+	using word_t = std::uint64_t;
+	static constexpr std::size_t WORD_BITS = 64;
+	using position_t = std::uint64_t;
+	
+	bool dense = false;
+	std::size_t count = 0;
+	std::vector<Minterm> sortedMinterms;
+	std::vector<bool> erased;
+	std::vector<word_t> bitmap;
+	
+	[[nodiscard]] static bool shouldBeDense(const std::uint64_t size);
+	[[nodiscard]] static word_t makeCubePattern(const Implicant &cube);
+	[[nodiscard]] position_t getEndPosition() const { return dense ? bitmap.size() * WORD_BITS : sortedMinterms.size(); }
+	[[nodiscard]] position_t findValidPosition(position_t position) const;
+	void makeDense();
+	void recount();
+	
+public:
+	class const_iterator
+	{
+		const Minterms *minterms;
+		position_t position;
+		friend class Minterms;
+		const_iterator(const Minterms &minterms, const position_t position) : minterms(&minterms), position(position) {}
+	public:
+		using iterator_category = std::forward_iterator_tag;
+		using value_type = Minterm;
+		using difference_type = std::ptrdiff_t;
+		using pointer = const Minterm*;
+		using reference = Minterm;
+		
+		[[nodiscard]] Minterm operator*() const { return minterms->dense ? static_cast<Minterm>(position) : minterms->sortedMinterms[position]; }
+		const_iterator& operator++() { position = minterms->findValidPosition(position + 1); return *this; }
+		const_iterator operator++(int) { const const_iterator copy = *this; ++*this; return copy; }
+		[[nodiscard]] bool operator==(const const_iterator &other) const { return this->position == other.position; }
+		[[nodiscard]] bool operator!=(const const_iterator &other) const { return this->position != other.position; }
+	};
+	using iterator = const_iterator;
+	
+	Minterms() = default;
+	explicit Minterms(std::vector<Minterm> &&minterms);
+	Minterms(std::vector<Minterm> &&minterms, const std::vector<Implicant> &cubes);  // Big cubes are put into the bitmap a word at a time instead of being expanded.
+	explicit Minterms(const std::string_view bitPlane, const std::string_view otherBitPlane = {});  // A (union of) packed bit-plane(s) (LSB first), each `::maxMinterm / 8 + 1` bytes long.
+	
+	[[nodiscard]] std::size_t size() const { return count; }
+	[[nodiscard]] bool empty() const { return count == 0; }
+	[[nodiscard]] bool isDense() const { return dense; }
+	
+	[[nodiscard]] const_iterator begin() const { return {*this, findValidPosition(0)}; }
+	[[nodiscard]] const_iterator end() const { return {*this, getEndPosition()}; }
+	[[nodiscard]] const_iterator cbegin() const { return begin(); }
+	[[nodiscard]] const_iterator cend() const { return end(); }
+	
+	[[nodiscard]] bool contains(const Minterm minterm) const;
+	[[nodiscard]] bool intersects(const Implicant &cube) const;
+	
+	const_iterator erase(const_iterator iter);
+	bool erase(const Minterm minterm);
+	void insert(const Minterms &other);
+};
@@ -1,5 +1,7 @@
 #include "./Names.hh"
 
+#include <cctype>
+
 #include "utils.hh"
 
 
@@ -77,3 +79,15 @@ void Names::printMathNames(std::ostream &o) const
 		o << name;
 	}
 }
+
+void Names::printPlaName(std::ostream &o, const std::size_t i) const
+{
+	// Names in PLA are separated by whitespaces and "#" starts a comment, so they are replaced to keep the file readable back.
+	if (names[i].empty())
+	{
+		o << '_';
+		return;
+	}
+	for (const char c : names[i])
+		o << (std::isspace(static_cast<unsigned char>(c)) || c == '#' ? '_' : c);
+}
@@ -21,9 +21,12 @@ public:
 	Names() = default;
 	Names(const bool useInCode, names_t &&names, const std::string_view replacementName) : useInCode(useInCode), names(std::move(names)), replacementName(replacementName) {}
 	Names(const Names &) = delete;
+	Names(Names &&) = default;
 	Names& operator=(const Names &) = delete;
 	Names& operator=(Names &&) = default;
 	
+	[[nodiscard]] Names copy() const { return {useInCode, names_t(names), replacementName}; }  // Copying has to be explicit as it is rarely needed.
+	
 	void printHumanName(std::ostream &o, const std::size_t i) const { o << names[i]; }
 	void printGraphName(std::ostream &o, const std::size_t i) const { o << names[i]; }
 	void printVerilogName(std::ostream &o, const std::size_t i) const { if (useInCode) o << names[i]; else o << replacementName << '[' << i << ']'; }
@@ -36,6 +39,7 @@ public:
 	void printCppType(std::ostream &o) const;
 	void printMathName(std::ostream &o, const std::size_t i) const { o << names[i]; }
 	void printMathNames(std::ostream &o) const;
+	void printPlaName(std::ostream &o, const std::size_t i) const;
 	
 	[[nodiscard]] bool isEmpty() const { return names.empty(); }
 	[[nodiscard]] std::size_t getSize() const { return names.size(); }
@@ -3,6 +3,7 @@
 #include <algorithm>
 #include <cassert>
 #include <iomanip>
+#include <numeric>
 
 #include "options.hh"
 #include "SetOptimizerForProducts.hh"
@@ -881,13 +882,13 @@ void OptimizedSolutions::createNegatedInputs(const solutions_t &solutions)
 			negatedInputs |= x.getFalseBits();
 }
 
-OptimizedSolutions::finalPrimeImplicants_t OptimizedSolutions::extractCommonProductParts(const solutions_t &solutions, Progress &progress)
+OptimizedSolutions::finalPrimeImplicants_t OptimizedSolutions::extractCommonProductParts(const solutions_t &solutions, Progress &progress, Caches *const caches)
 {
 	std::vector<Implicant> oldPrimeImplicants;
 	for (const Solution *const solution : solutions)
 		for (const auto &product: *solution)
 			oldPrimeImplicants.push_back(product);
-	const auto [newPrimeImplicants, finalPrimeImplicants, subsetSelections] = SetOptimizerForProducts::optimizeSet(oldPrimeImplicants, progress);
+	const auto [newPrimeImplicants, finalPrimeImplicants, subsetSelections] = SetOptimizerForProducts::optimizeSet(oldPrimeImplicants, progress, caches == nullptr ? nullptr : &caches->products);
 	
 	products.reserve(subsetSelections.size());
 	for (std::size_t i = 0; i != subsetSelections.size(); ++i)
@@ -896,7 +897,7 @@ OptimizedSolutions::finalPrimeImplicants_t OptimizedSolutions::extractCommonProd
 	return finalPrimeImplicants;
 }
 
-void OptimizedSolutions::extractCommonSumParts(const solutions_t &solutions, const finalPrimeImplicants_t &finalPrimeImplicants, Progress &progress)
+void OptimizedSolutions::extractCommonSumParts(const solutions_t &solutions, const finalPrimeImplicants_t &finalPrimeImplicants, Progress &progress, Caches *const caches)
 {
 	std::vector<std::set<std::size_t>> oldIdSets;
 	{
@@ -909,7 +910,7 @@ void OptimizedSolutions::extractCommonSumParts(const solutions_t &solutions, con
 				oldIdSet.insert(finalPrimeImplicants[i++]);
 		}
 	}
-	const auto [newIdSets, finalIdSets, subsetSelections] = SetOptimizerForSums::optimizeSet(oldIdSets, progress);
+	const auto [newIdSets, finalIdSets, subsetSelections] = SetOptimizerForSums::optimizeSet(oldIdSets, progress, caches == nullptr ? nullptr : &caches->sums);
 	
 	sums.reserve(subsetSelections.size());
 	for (std::size_t i = 0; i != subsetSelections.size(); ++i)
@@ -989,16 +990,144 @@ void OptimizedSolutions::validate(const solutions_t &solutions, Progress &progre
 }
 #endif
 
-OptimizedSolutions::OptimizedSolutions(const solutions_t &solutions, Progress &progress)
+OptimizedSolutions::OptimizedSolutions(const solutions_t &solutions, Progress &progress, Caches *const caches)
 {
 	createNegatedInputs(solutions);
-	const finalPrimeImplicants_t finalPrimeImplicants = extractCommonProductParts(solutions, progress);
-	extractCommonSumParts(solutions, finalPrimeImplicants, progress);
+	const finalPrimeImplicants_t finalPrimeImplicants = extractCommonProductParts(solutions, progress, caches);
+	extractCommonSumParts(solutions, finalPrimeImplicants, progress, caches);
 #ifndef NDEBUG
 	validate(solutions, progress);
 #endif
 }
 
+std::size_t OptimizedSolutions::countMinGates(const std::size_t inputCount, const std::vector<std::vector<std::size_t>> &outputs)
+{
+	// Outputs made of the same associative operation are joined into groups through their shared inputs. No gate can mix two groups, since its output would contain inputs of both.
+	const auto findRoot = [](std::vector<std::size_t> &roots, std::size_t input){
+			while (roots[input] != input)
+				input = roots[input] = roots[roots[input]];
+			return input;
+		};
+	std::vector<std::size_t> roots(inputCount);
+	std::iota(roots.begin(), roots.end(), std::size_t(0));
+	std::vector<bool> isUsed(inputCount, false);
+	for (const std::vector<std::size_t> &output : outputs)
+	{
+		for (const std::size_t input : output)
+		{
+			roots[findRoot(roots, input)] = findRoot(roots, output.front());
+			isUsed[input] = true;
+		}
+	}
+	std::vector<std::size_t> inputCounts(inputCount, 0);
+	for (std::size_t input = 0; input != inputCount; ++input)
+		if (isUsed[input])
+			++inputCounts[findRoot(roots, input)];
+	std::vector<std::vector<std::size_t>> outputsOfGroups(inputCount);
+	for (std::size_t i = 0; i != outputs.size(); ++i)
+		outputsOfGroups[findRoot(roots, outputs[i].front())].push_back(i);
+	
+	// Joining the inputs of a group together needs at least one gate fewer than there are of them, and every distinct output needs at least its own last gate.
+	// Moreover, any output needs its own inputs joined first, and none of those gates can be the last one of an output that is not its subset.
+	// Going through the outputs from the biggest ones, each of them also needs at least as many new gates as it takes to join its new inputs to the clusters of the previous outputs it touches.
+	std::vector<std::size_t> clusterRoots(inputCount);
+	std::iota(clusterRoots.begin(), clusterRoots.end(), std::size_t(0));
+	std::vector<bool> isClustered(inputCount, false);
+	std::vector<std::size_t> touchedClusters;
+	std::size_t gateCount = 0;
+	for (std::size_t root = 0; root != inputCount; ++root)
+	{
+		std::vector<std::size_t> &outputsOfGroup = outputsOfGroups[root];
+		if (outputsOfGroup.empty())
+			continue;
+		std::size_t groupGateCount = std::max(inputCounts[root] - 1, outputsOfGroup.size());
+		for (const std::size_t i : outputsOfGroup)
+		{
+			const std::vector<std::size_t> &output = outputs[i];
+			const std::size_t otherOutputCount = static_cast<std::size_t>(std::count_if(outputsOfGroup.cbegin(), outputsOfGroup.cend(), [&outputs, &output](const std::size_t j){ return !std::includes(output.cbegin(), output.cend(), outputs[j].cbegin(), outputs[j].cend()); }));
+			groupGateCount = std::max(groupGateCount, output.size() - 1 + std::max(inputCounts[root] - output.size(), otherOutputCount));
+		}
+		
+		std::stable_sort(outputsOfGroup.begin(), outputsOfGroup.end(), [&outputs](const std::size_t i, const std::size_t j){ return outputs[i].size() > outputs[j].size(); });
+		std::size_t chainGateCount = 0;
+		for (auto i = outputsOfGroup.cbegin(); i != outputsOfGroup.cend(); ++i)
+		{
+			const std::vector<std::size_t> &output = outputs[*i];
+			const bool isNew = std::none_of(outputsOfGroup.cbegin(), i, [&outputs, &output](const std::size_t j){ return std::includes(outputs[j].cbegin(), outputs[j].cend(), output.cbegin(), output.cend()); });
+			std::size_t newInputCount = 0;
+			touchedClusters.clear();
+			for (const std::size_t input : output)
+			{
+				if (isClustered[input])
+					touchedClusters.push_back(findRoot(clusterRoots, input));
+				else
+					++newInputCount;
+			}
+			std::sort(touchedClusters.begin(), touchedClusters.end());
+			const std::size_t touchedClusterCount = static_cast<std::size_t>(std::unique(touchedClusters.begin(), touchedClusters.end()) - touchedClusters.begin());
+			chainGateCount += std::max(newInputCount + touchedClusterCount - 1, std::size_t(isNew ? 1 : 0));
+			for (const std::size_t input : output)
+			{
+				clusterRoots[findRoot(clusterRoots, input)] = findRoot(clusterRoots, output.front());
+				isClustered[input] = true;
+			}
+		}
+		groupGateCount = std::max(groupGateCount, chainGateCount);
+		gateCount += groupGateCount;
+	}
+	return gateCount;
+}
+
+std::size_t OptimizedSolutions::calcGateScoreLowerBound(const solutions_t &solutions)
+{
+	// Every negated input needs its own NOT gate no matter how the rest is shared.
+	Minterm negatedInputs = 0;
+	std::vector<Implicant> primeImplicants;
+	for (const Solution *const solution : solutions)
+	{
+		for (const Implicant &primeImplicant : *solution)
+		{
+			negatedInputs |= primeImplicant.getFalseBits();
+			primeImplicants.push_back(primeImplicant);
+		}
+	}
+	std::sort(primeImplicants.begin(), primeImplicants.end());
+	primeImplicants.erase(std::unique(primeImplicants.begin(), primeImplicants.end()), primeImplicants.end());
+	
+	// Products are built from literals, where a literal is an input or a negated input.
+	std::vector<std::vector<std::size_t>> products;
+	for (const Implicant &primeImplicant : primeImplicants)
+	{
+		if (primeImplicant.getBitCount() < 2)
+			continue;
+		std::vector<std::size_t> &literals = products.emplace_back();
+		for (Minterm bit = 0; bit != ::maxBits; ++bit)
+		{
+			if ((primeImplicant.getTrueBits() >> bit & 1) != 0)
+				literals.push_back(bit);
+			else if ((primeImplicant.getFalseBits() >> bit & 1) != 0)
+				literals.push_back(::maxBits + bit);
+		}
+		std::sort(literals.begin(), literals.end());
+	}
+	
+	// Sums are built from the products, so each distinct prime implicant is one input of them.
+	std::vector<std::vector<std::size_t>> sums;
+	for (const Solution *const solution : solutions)
+	{
+		if (solution->size() < 2)
+			continue;
+		std::vector<std::size_t> &ids = sums.emplace_back();
+		for (const Implicant &primeImplicant : *solution)
+			ids.push_back(static_cast<std::size_t>(std::lower_bound(primeImplicants.cbegin(), primeImplicants.cend(), primeImplicant) - primeImplicants.cbegin()));
+		std::sort(ids.begin(), ids.end());
+	}
+	std::sort(sums.begin(), sums.end());
+	sums.erase(std::unique(sums.begin(), sums.end()), sums.end());
+	
+	return getCost(std::bitset<32>(negatedInputs).count(), countMinGates(2 * ::maxBits, products), countMinGates(primeImplicants.size(), sums));
+}
+
 std::pair<bool, bool> OptimizedSolutions::checkForUsedConstants() const
 {
 	bool usesFalse = false, usesTrue = false;
@@ -12,6 +12,8 @@
 #include "Implicant.hh"
 #include "Names.hh"
 #include "Progress.hh"
+#include "SetOptimizerForProducts.hh"
+#include "SetOptimizerForSums.hh"
 #include "Solution.hh"
 
 
@@ -19,6 +21,15 @@ class OptimizedSolutions final : public GateCost
 {
 public:
 	using solutions_t = std::vector<const Solution*>;
+	// Caches of common parts of products and sums that are shared by optimizations of many combinations of solutions.
+	// Their results are made from sorted sets, so they have the same cost but they may list the parts in a different order.
+	struct Caches
+	{
+		SetOptimizerForProducts::Cache products;
+		SetOptimizerForSums::Cache sums;
+		
+		explicit Caches(const std::size_t maxSize) : products(maxSize), sums(maxSize) {}
+	};
 	
 private:
 	using id_t = std::size_t;
@@ -97,8 +108,10 @@ private:
 	void printCppFinalSums(std::ostream &o, const Names &functionNames) const;
 	
 	void createNegatedInputs(const solutions_t &solutions);
-	finalPrimeImplicants_t extractCommonProductParts(const solutions_t &solutions, Progress &progress);
-	void extractCommonSumParts(const solutions_t &solutions, const finalPrimeImplicants_t &finalPrimeImplicants, Progress &progress);
+	finalPrimeImplicants_t extractCommonProductParts(const solutions_t &solutions, Progress &progress, Caches *const caches);
+	void extractCommonSumParts(const solutions_t &solutions, const finalPrimeImplicants_t &finalPrimeImplicants, Progress &progress, Caches *const caches);
+	
+	static std::size_t countMinGates(const std::size_t inputCount, const std::vector<std::vector<std::size_t>> &outputs);
 	
 	static id_t makeProductId(const std::size_t index) { return index; }
 	id_t makeSumId(const std::size_t index) const { return index + products.size(); }
@@ -114,7 +127,10 @@ private:
 	
 public:
 	OptimizedSolutions() = default;
-	OptimizedSolutions(const solutions_t &solutions, Progress &progress);
+	OptimizedSolutions(const solutions_t &solutions, Progress &progress, Caches *const caches = nullptr);
+	
+	// A gate score that no optimization of these solutions can go below. It is also a valid bound for any solutions of a superset of these functions.
+	[[nodiscard]] static std::size_t calcGateScoreLowerBound(const solutions_t &solutions);
 	
 	std::size_t getSize() const { return finalSums.size(); }
 	
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <charconv>
 #include <iostream>
 
 #include "global.hh"
@@ -124,6 +125,30 @@ namespace options
 		return false;
 	}
 	
+	template<typename T>
+	bool Number<T>::parse(std::string_view argument)
+	{
+		static const std::regex defaultRegex("d(efault)?|auto", std::regex_constants::icase | std::regex_constants::nosubs);
+		std::cmatch match;
+		if (std::regex_match(&*argument.begin(), &*argument.end(), match, defaultRegex))
+		{
+			value.reset();
+			return true;
+		}
+		T number;
+		const auto [end, error] = std::from_chars(&*argument.begin(), &*argument.end(), number);
+		if (error != std::errc() || end != &*argument.end() || number < min || number > max)
+		{
+			std::cerr << "Invalid value \"" << argument << "\" for the option \"--" << getLongNames().front() << "\"!\n";
+			std::cerr << "Allowed values are numbers from " << min << " to " << max << " and \"default\".\n";
+			return false;
+		}
+		value = number;
+		return true;
+	}
+	
+	template class Number<unsigned>;
+	
 	
 	namespace
 	{
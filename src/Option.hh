@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cassert>
 #include <functional>
 #include <optional>
 #include <regex>
@@ -27,6 +28,7 @@ namespace options
 		
 		[[nodiscard]] virtual bool needsArgument() const = 0;
 		[[nodiscard]] virtual bool parse(std::string_view argument) = 0;
+		virtual void resolveDefault() {}  // Computes the default value if it wasn't set, so reading the value later doesn't write anything.
 	};
 	
 	class NoArgOption : public Option
@@ -79,7 +81,8 @@ namespace options
 		
 		void setValue(const bool newValue) { undecided = false; value = newValue; }
 		void resetValue() { undecided = true; }
-		[[nodiscard]] bool getValue() { if (undecided) { value = getDefault(); undecided = false; } return value; }
+		void resolveDefault() final { if (undecided) { value = getDefault(); undecided = false; } }
+		[[nodiscard]] bool getValue() const { assert(!undecided); return value; }
 	};
 	
 	class Choice : public Option
@@ -136,6 +139,26 @@ namespace options
 		[[nodiscard]] T getValue() const { const std::size_t i = choice.getValue(); return i == SIZE_MAX ? DEFAULT_VALUE : values[i]; }
 	};
 	
+	template<typename T>
+	class Number : public Option
+	{
+		using getDefault_t = std::function<T()>;
+		const getDefault_t getDefault;
+		const T min, max;
+		std::optional<T> value;
+		
+	public:
+		Number(std::vector<std::string_view> &&longNames, const char shortName, const T min, const T max, const getDefault_t getDefault) : Option(std::move(longNames), shortName), getDefault(getDefault), min(min), max(max) {}
+		
+		[[nodiscard]] bool needsArgument() const final { return true; }
+		[[nodiscard]] bool parse(std::string_view argument) final;
+		
+		void setValue(const T newValue) { value = newValue; }
+		void resetValue() { value.reset(); }
+		void resolveDefault() final { if (!value) value = getDefault(); }
+		[[nodiscard]] T getValue() const { assert(value); return *value; }
+	};
+	
 	class Text : public Option
 	{
 		std::optional<std::string> value;
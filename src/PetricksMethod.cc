@@ -10,152 +10,377 @@
 #include <sstream>
 
 #include "options.hh"
+#include "TimeLimit.hh"
+#include "utils.hh"
 
 
 template<typename INDEX_T>
-typename PetricksMethod<INDEX_T>::index_t PetricksMethod<INDEX_T>::findEssentialPrimeImplicantIndex(const Minterm minterm)
+CoverageTable PetricksMethod<INDEX_T>::createCoverageTable(const std::string &functionName) const
 {
-	std::uint_fast8_t count = 0;
-	assert(!primeImplicants.empty());
-	index_t index = 0;  // Initialized only to avoid a compiler warning.
-	for (index_t i = 0; i != primeImplicants.size(); ++i)
-	{
-		if (primeImplicants[i].covers(minterm))
-		{
-			if (++count == 2)
-				return NO_INDEX;
-			index = i;
-		}
-	}
-	return count != 0 ? index : NO_INDEX;
+	const std::string progressName = "Creating coverage table for \"" + functionName + '"';
+	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
+	progress.step();
+	return CoverageTable(minterms, primeImplicants, progress);
 }
 
 template<typename INDEX_T>
-typename PetricksMethod<INDEX_T>::primeImplicants_t PetricksMethod<INDEX_T>::extractEssentials(const std::string &functionName)
+typename PetricksMethod<INDEX_T>::primeImplicants_t PetricksMethod<INDEX_T>::extractEssentials(CoverageTable &table, const std::string &functionName)
 {
 	const std::string progressName = "Extracting essentials of \"" + functionName + '"';
 	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
 	progress.step();
-	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(minterms.size()));
+	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(table.getRowCount()));
 	
 	primeImplicants_t essentials;
-	for (typename minterms_t::const_iterator iter = minterms.cbegin(); iter != minterms.cend();)
+	CoverageTable::selection_t essentialColumns(table.getColumnCount(), false), coveredRows(table.getRowCount(), false);
+	for (std::size_t row = 0; row != table.getRowCount(); ++row)
 	{
 		progressStep.substep();
-		const index_t essentialPrimeImplicantIndex = findEssentialPrimeImplicantIndex(*iter);
-		if (essentialPrimeImplicantIndex == NO_INDEX)
-		{
-			++iter;
+		if (coveredRows[row] || table.countRow(row) != 1)
 			continue;
-		}
-		essentials.emplace_back(std::move(primeImplicants[essentialPrimeImplicantIndex]));
-		primeImplicants.erase(primeImplicants.begin() + essentialPrimeImplicantIndex);
-		const Implicant &primeImplicant = essentials.back();
-		for (typename minterms_t::const_iterator jiter = minterms.cbegin(); jiter != iter;)
-			if (primeImplicant.covers(*jiter))
-				jiter = minterms.erase(jiter);
-			else
-				++jiter;
-		for (typename minterms_t::const_iterator jiter = std::next(iter); jiter != minterms.cend();)
-			if (primeImplicant.covers(*jiter))
-				jiter = minterms.erase(jiter);
-			else
-				++jiter;
-		iter = minterms.erase(iter);
+		const std::size_t column = table.findFirstInRow(row);
+		essentials.push_back(primeImplicants[column]);
+		essentialColumns[column] = true;
+		// Only the rows after the current one need to be marked because the previous ones won't be visited again.
+		for (std::size_t otherRow = row; otherRow != table.getRowCount(); ++otherRow)
+			if (table.get(otherRow, column))
+				coveredRows[otherRow] = true;
 	}
+	
+	coveredRows = table.findRowsIntersecting(essentialColumns);
+	CoverageTable::selection_t remainingRows(table.getRowCount()), remainingColumns(table.getColumnCount());
+	for (std::size_t row = 0; row != table.getRowCount(); ++row)
+		remainingRows[row] = !coveredRows[row];
+	primeImplicants_t remainingPrimeImplicants;
+	for (std::size_t column = 0; column != table.getColumnCount(); ++column)
+	{
+		remainingColumns[column] = !essentialColumns[column];
+		if (remainingColumns[column])
+			remainingPrimeImplicants.push_back(std::move(primeImplicants[column]));
+	}
+	table = table.select(remainingRows, remainingColumns);
+	primeImplicants = std::move(remainingPrimeImplicants);
 	return essentials;
 }
 
 template<typename INDEX_T>
-typename PetricksMethod<INDEX_T>::productOfSumsOfProducts_t PetricksMethod<INDEX_T>::createPreliminaryProductOfSums(const std::string &functionName) const
+void PetricksMethod<INDEX_T>::removeRedundantRows(CoverageTable &table, const std::string &functionName)
 {
-	const std::string progressName = "Creating initial solution space for \"" + functionName + '"';
+	// A minterm is redundant when every prime implicant that covers another minterm covers also this one.
+	const std::string progressName = "Cleaning up solution space for \"" + functionName + '"';
 	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
 	progress.step();
-	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(minterms.size()));
-	productOfSumsOfProducts_t productOfSums;
-	for (const Minterm &minterm : minterms)
+	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(table.getRowCount()));
+	// Most pairs of rows are rejected by checking only whether one row contains the first column of the other.
+	std::vector<std::size_t> firstColumns(table.getRowCount());
+	for (std::size_t row = 0; row != table.getRowCount(); ++row)
+		firstColumns[row] = table.findFirstInRow(row);
+	const auto mayBeSubset = [&table, &firstColumns](const std::size_t subsetRow, const std::size_t supersetRow){
+			return firstColumns[subsetRow] == SIZE_MAX || table.get(supersetRow, firstColumns[subsetRow]);
+		};
+	CoverageTable::selection_t remainingRows(table.getRowCount(), true);
+	for (std::size_t x = 0; x != table.getRowCount(); ++x)
 	{
 		progressStep.substep();
-		sumOfProducts_t &sum = productOfSums.emplace_back();
-		for (index_t i = 0; i != primeImplicants.size(); ++i)
-			if (primeImplicants[i].covers(minterm))
-				sum.emplace_back().push_back(i);
+		if (!remainingRows[x])
+			continue;
+		for (std::size_t y = x + 1; y != table.getRowCount(); ++y)
+		{
+			if (!remainingRows[y])
+				continue;
+			if (mayBeSubset(y, x) && table.isRowSubset(y, x))
+			{
+				remainingRows[x] = false;
+				break;
+			}
+			else if (mayBeSubset(x, y) && table.isRowSubset(x, y))
+			{
+				remainingRows[y] = false;
+			}
+		}
 	}
-	return productOfSums;
+	table = table.select(remainingRows, CoverageTable::selection_t(table.getColumnCount(), true));
 }
 
 template<typename INDEX_T>
-void PetricksMethod<INDEX_T>::removeRedundantSums(productOfSumsOfProducts_t &productOfSums, const std::string &functionName)
+bool PetricksMethod<INDEX_T>::extractSecondaryEssentials(CoverageTable &table, primeImplicants_t &essentials) const
 {
-	const std::string progressName = "Cleaning up solution space for \"" + functionName + '"';
-	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
-	progress.step();
-	auto progressStep = progress.makeCountingStepHelper(static_cast<Progress::completion_t>(productOfSums.size()));
-	for (auto x = productOfSums.begin(); x != productOfSums.end(); ++x)
+	// After the other reductions, some minterms may be left with only one prime implicant that covers them.
+	CoverageTable::selection_t essentialColumns(table.getColumnCount(), false);
+	bool anyEssential = false;
+	for (std::size_t row = 0; row != table.getRowCount(); ++row)
 	{
-		progressStep.substep();
-		if (!x->empty())
+		if (table.countRow(row) == 1)
+		{
+			essentialColumns[table.findFirstInRow(row)] = true;
+			anyEssential = true;
+		}
+	}
+	if (!anyEssential)
+		return false;
+	for (std::size_t column = 0; column != table.getColumnCount(); ++column)
+		if (essentialColumns[column])
+			essentials.push_back(primeImplicants[column]);
+	CoverageTable::selection_t remainingRows = table.findRowsIntersecting(essentialColumns);
+	remainingRows.flip();
+	table = table.select(remainingRows, CoverageTable::selection_t(table.getColumnCount(), true));
+	return true;
+}
+
+template<typename INDEX_T>
+bool PetricksMethod<INDEX_T>::removeDominatedPrimeImplicants(CoverageTable &table) const
+{
+	// A prime implicant is dominated when another one covers all the remaining minterms that it covers and it is not more expensive,
+	// i.e. it has no more inputs and no negated inputs that the first one doesn't have. Replacing the first one with it never makes a solution worse.
+	const CoverageTable columns = table.transpose();
+	std::vector<std::size_t> columnSizes(columns.getRowCount()), firstRows(columns.getRowCount());
+	for (std::size_t i = 0; i != columns.getRowCount(); ++i)
+	{
+		columnSizes[i] = columns.countRow(i);
+		firstRows[i] = columns.findFirstInRow(i);
+	}
+	CoverageTable::selection_t dominated(primeImplicants.size(), false);
+	bool anyDominated = false;
+	for (std::size_t i = 0; i != primeImplicants.size(); ++i)
+	{
+		if (columnSizes[i] == 0)
+			continue;
+		const Implicant &dominatedCandidate = primeImplicants[i];
+		for (std::size_t j = 0; j != primeImplicants.size(); ++j)
 		{
-			for (auto y = std::next(x); y != productOfSums.end(); ++y)
+			const Implicant &dominatingCandidate = primeImplicants[j];
+			if (j == i || dominated[j] || columnSizes[j] < columnSizes[i] || !columns.get(j, firstRows[i]))
+				continue;
+			const bool notWorse = dominatingCandidate.getBitCount() <= dominatedCandidate.getBitCount()
+					&& (dominatingCandidate.getFalseBits() & ~dominatedCandidate.getFalseBits()) == 0;
+			const bool strictlyBetter = dominatingCandidate.getBitCount() < dominatedCandidate.getBitCount()
+					|| dominatingCandidate.getFalseBits() != dominatedCandidate.getFalseBits()
+					|| columnSizes[j] != columnSizes[i];
+			if (notWorse && strictlyBetter && columns.isRowSubset(i, j))
 			{
-				if (!y->empty())
-				{
-					if (std::includes(x->cbegin(), x->cend(), y->cbegin(), y->cend()))
-					{
-						x->clear();
-						break;
-					}
-					else if (std::includes(y->cbegin(), y->cend(), x->cbegin(), x->cend()))
-					{
-						y->clear();
-					}
-				}
+				dominated[i] = true;
+				anyDominated = true;
+				break;
 			}
 		}
 	}
-	productOfSums.erase(std::remove_if(productOfSums.begin(), productOfSums.end(), [](const auto &x){ return x.empty(); }), productOfSums.end());
+	if (!anyDominated)
+		return false;
+	table.clearColumns(dominated);
+	return true;
 }
 
 template<typename INDEX_T>
-typename PetricksMethod<INDEX_T>::productOfSumsOfProducts_t PetricksMethod<INDEX_T>::createProductOfSums(const std::string &functionName) const
+void PetricksMethod<INDEX_T>::reduceToCyclicCore(CoverageTable &table, primeImplicants_t &essentials, const std::string &functionName) const
 {
-	productOfSumsOfProducts_t productOfSums = createPreliminaryProductOfSums(functionName);
-	removeRedundantSums(productOfSums, functionName);
+	// Minterms that are covered by all the prime implicants of another minterm are already removed by `removeRedundantRows`.
+	while (true)
+	{
+		const bool essentialsFound = extractSecondaryEssentials(table, essentials);
+		const bool dominatedFound = removeDominatedPrimeImplicants(table);
+		if (!essentialsFound && !dominatedFound)
+			break;
+		removeRedundantRows(table, functionName);
+	}
+}
+
+template<typename INDEX_T>
+typename PetricksMethod<INDEX_T>::productOfSumsOfProducts_t PetricksMethod<INDEX_T>::createProductOfSums(const CoverageTable &table)
+{
+	productOfSumsOfProducts_t productOfSums;
+	productOfSums.reserve(table.getRowCount());
+	for (std::size_t row = 0; row != table.getRowCount(); ++row)
+	{
+		sumOfProducts_t &sum = productOfSums.emplace_back();
+		for (const std::size_t column : table.listRow(row))
+			sum.emplace_back().push_back(static_cast<index_t>(column));
+	}
 	return productOfSums;
 }
 
 template<typename INDEX_T>
-inline typename PetricksMethod<INDEX_T>::sumOfProducts_t PetricksMethod<INDEX_T>::multiplySumsOfProducts(const sumOfProducts_t &multiplier0, const sumOfProducts_t &multiplier1, long double &actualOperations, const long double expectedOperations, Progress &progress)
+void PetricksMethod<INDEX_T>::orderSums(productOfSumsOfProducts_t &productOfSumsOfProducts) const
 {
-	product_t newProduct;
-	newProduct.reserve(multiplier0.front().size() + multiplier1.front().size());
-	HasseDiagram<index_t> hasseDiagram;
+	// Each sum is followed by the remaining one that shares the most prime implicants with it.
+	// The sums are then multiplied as neighbours, so most of the products of each multiplication absorb each other and the intermediate results stay small.
+	// (Multiplying the smallest sums first, as in Huffman coding, looks cheaper but it pairs unrelated sums and their products barely absorb anything.)
+	std::vector<std::vector<std::size_t>> sumsOfPrimeImplicants(primeImplicants.size());
+	for (std::size_t i = 0; i != productOfSumsOfProducts.size(); ++i)
+		for (const product_t &product : productOfSumsOfProducts[i])
+			sumsOfPrimeImplicants[product.front()].push_back(i);
+	
+	std::vector<bool> used(productOfSumsOfProducts.size(), false);
+	std::vector<std::size_t> order, sharedCounts(productOfSumsOfProducts.size(), 0), candidates;
+	order.reserve(productOfSumsOfProducts.size());
+	std::size_t firstUnused = 0;
+	while (order.size() != productOfSumsOfProducts.size())
 	{
-		std::size_t operationsThisTime = 0;
-		const auto estimateCompletion = [actualOperations, &operationsThisTime = std::as_const(operationsThisTime), expectedOperations](){ return static_cast<Progress::completion_t>((actualOperations + operationsThisTime) / expectedOperations); };
-		const auto infoGuard = progress.addInfo("expanding");
-		for (const product_t &x : multiplier0)
+		std::size_t next = productOfSumsOfProducts.size();
+		if (!order.empty())
 		{
-			for (const product_t &y : multiplier1)
+			candidates.clear();
+			for (const product_t &product : productOfSumsOfProducts[order.back()])
+				for (const std::size_t i : sumsOfPrimeImplicants[product.front()])
+					if (!used[i] && sharedCounts[i]++ == 0)
+						candidates.push_back(i);
+			std::size_t mostShared = 0;
+			for (const std::size_t i : candidates)
 			{
-				progress.substep(estimateCompletion, operationsThisTime == 0);
-				++operationsThisTime;
-				newProduct.clear();
-				std::set_union(x.cbegin(), x.cend(), y.cbegin(), y.cend(), std::back_inserter(newProduct));
-				hasseDiagram.insertRemovingSupersets(std::move(newProduct));
+				if (sharedCounts[i] > mostShared || (sharedCounts[i] == mostShared && i < next))
+				{
+					mostShared = sharedCounts[i];
+					next = i;
+				}
+				sharedCounts[i] = 0;
 			}
 		}
-		actualOperations += operationsThisTime;
+		if (next == productOfSumsOfProducts.size())
+		{
+			while (used[firstUnused])
+				++firstUnused;
+			next = firstUnused;
+		}
+		used[next] = true;
+		order.push_back(next);
+	}
+	
+	productOfSumsOfProducts_t orderedSums;
+	orderedSums.reserve(productOfSumsOfProducts.size());
+	for (const std::size_t i : order)
+		orderedSums.push_back(std::move(productOfSumsOfProducts[i]));
+	productOfSumsOfProducts = std::move(orderedSums);
+}
+
+template<typename INDEX_T>
+std::size_t PetricksMethod<INDEX_T>::calcThreadCount(const std::size_t maxThreadCount, const std::size_t multiplier0Size, const std::size_t multiplier1Size)
+{
+	// Threads split `multiplier0`, so there cannot be more of them than its products.
+	const std::uintmax_t operations = static_cast<std::uintmax_t>(multiplier0Size) * static_cast<std::uintmax_t>(multiplier1Size);
+	return static_cast<std::size_t>(std::max<std::uintmax_t>(std::min<std::uintmax_t>({maxThreadCount, multiplier0Size, operations / MIN_OPERATIONS_PER_THREAD}), 1));
+}
+
+template<typename INDEX_T>
+typename PetricksMethod<INDEX_T>::sumOfProducts_t PetricksMethod<INDEX_T>::multiplySumsOfProducts(const sumOfProducts_t &multiplier0, const sumOfProducts_t &multiplier1, const std::size_t maxThreadCount, ExpansionProgress &expansionProgress)
+{
+	// Each thread multiplies its own part of `multiplier0` into its own diagram.
+	const std::size_t threadCount = calcThreadCount(maxThreadCount, multiplier0.size(), multiplier1.size());
+	std::vector<HasseDiagram<index_t>> hasseDiagrams(threadCount);
+	{
+		expansionProgress.setStage("expanding");
+		expansionProgress.substep(true);
+		runInParallel(threadCount, [&multiplier0, &multiplier1, &expansionProgress, &hasseDiagrams, threadCount](const std::size_t threadIndex){
+				HasseDiagram<index_t> &hasseDiagram = hasseDiagrams[threadIndex];
+				product_t newProduct;
+				newProduct.reserve(multiplier0.front().size() + multiplier1.front().size());
+				const std::size_t begin = multiplier0.size() * threadIndex / threadCount, end = multiplier0.size() * (threadIndex + 1) / threadCount;
+				// When the time is up, the rest of `multiplier0` is skipped. Any product of the partial result still satisfies both sums, so it remains valid, only incomplete.
+				for (std::size_t i = begin; i != end && (i == begin || !TimeLimit::isUp()); ++i)
+				{
+					const product_t &x = multiplier0[i];
+					for (const product_t &y : multiplier1)
+					{
+						expansionProgress.substep();
+						newProduct.clear();
+						std::set_union(x.cbegin(), x.cend(), y.cbegin(), y.cend(), std::back_inserter(newProduct));
+						hasseDiagram.insertRemovingSupersets(std::move(newProduct));
+					}
+					expansionProgress.addOperations(multiplier1.size());
+				}
+			});
+	}
+	{
+		expansionProgress.setStage("refining");
+		expansionProgress.substep(true);
+		if (threadCount == 1)
+			return hasseDiagrams.front().getSets();
+		// A product is dropped when another thread has a smaller one. If both threads have the same product, it is kept only by the first one.
+		std::vector<sumOfProducts_t> partialResults(threadCount);
+		runInParallel(threadCount, [&hasseDiagrams, &partialResults, threadCount](const std::size_t threadIndex){
+				sumOfProducts_t products = hasseDiagrams[threadIndex].getSets();
+				products.erase(std::remove_if(products.begin(), products.end(), [&hasseDiagrams, threadCount, threadIndex](const product_t &product){
+						for (std::size_t otherIndex = 0; otherIndex != threadCount; ++otherIndex)
+							if (otherIndex < threadIndex ? hasseDiagrams[otherIndex].containsSubset(product) : otherIndex > threadIndex && hasseDiagrams[otherIndex].containsProperSubset(product))
+								return true;
+						return false;
+					}), products.end());
+				partialResults[threadIndex] = std::move(products);
+			});
+		sumOfProducts_t result;
+		for (sumOfProducts_t &partialResult : partialResults)
+			result.insert(result.end(), std::make_move_iterator(partialResult.begin()), std::make_move_iterator(partialResult.end()));
+		return result;
+	}
+}
+
+template<typename INDEX_T>
+ProductBitsets PetricksMethod<INDEX_T>::multiplySumsOfProducts(const ProductBitsets &multiplier0, const ProductBitsets &multiplier1, const std::size_t maxThreadCount, ExpansionProgress &expansionProgress)
+{
+	// Each thread multiplies its own part of `multiplier0` into its own list.
+	// Supersets are removed in batches, so the buffer doesn't grow much beyond the size of the result.
+	const std::size_t threadCount = calcThreadCount(maxThreadCount, multiplier0.size(), multiplier1.size());
+	std::vector<ProductBitsets> partialResults(threadCount, ProductBitsets(multiplier0.getBitCount()));
+	{
+		expansionProgress.setStage("expanding");
+		expansionProgress.substep(true);
+		runInParallel(threadCount, [&multiplier0, &multiplier1, &expansionProgress, &partialResults, threadCount](const std::size_t threadIndex){
+				ProductBitsets &partialResult = partialResults[threadIndex];
+				std::size_t sizeAfterCleanup = 0;
+				const std::size_t begin = multiplier0.size() * threadIndex / threadCount, end = multiplier0.size() * (threadIndex + 1) / threadCount;
+				// The time limit is handled the same way as in the other overload.
+				for (std::size_t i = begin; i != end && (i == begin || !TimeLimit::isUp()); ++i)
+				{
+					for (std::size_t j = 0; j != multiplier1.size(); ++j)
+					{
+						expansionProgress.substep();
+						partialResult.pushUnion(multiplier0[i], multiplier1[j]);
+					}
+					expansionProgress.addOperations(multiplier1.size());
+					if (partialResult.size() >= 2 * sizeAfterCleanup + 0x10000)
+					{
+						partialResult.removeSupersets();
+						sizeAfterCleanup = partialResult.size();
+					}
+				}
+				partialResult.removeSupersets();
+			});
 	}
-	{	
-		const auto estimateCompletion = [&actualOperations = std::as_const(actualOperations), expectedOperations](){ return static_cast<Progress::completion_t>(actualOperations / expectedOperations); };
-		const auto infoGuard = progress.addInfo("refining");
-		progress.substep(estimateCompletion, true);
-		return hasseDiagram.getSets();
+	{
+		expansionProgress.setStage("refining");
+		expansionProgress.substep(true);
+		if (threadCount == 1)
+			return std::move(partialResults.front());
+		// A product is dropped when another thread has a smaller one. If both threads have the same product, it is kept only by the first one.
+		std::vector<ProductBitsets> filteredResults(threadCount, ProductBitsets(multiplier0.getBitCount()));
+		runInParallel(threadCount, [&partialResults, &filteredResults, threadCount](const std::size_t threadIndex){
+				const ProductBitsets &partialResult = partialResults[threadIndex];
+				for (std::size_t i = 0; i != partialResult.size(); ++i)
+				{
+					bool isSuperset = false;
+					for (std::size_t otherIndex = 0; otherIndex != threadCount && !isSuperset; ++otherIndex)
+						isSuperset = otherIndex < threadIndex ? partialResults[otherIndex].containsSubset(partialResult[i]) : otherIndex > threadIndex && partialResults[otherIndex].containsProperSubset(partialResult[i]);
+					if (!isSuperset)
+						filteredResults[threadIndex].push(partialResult[i]);
+				}
+			});
+		ProductBitsets result(multiplier0.getBitCount());
+		for (const ProductBitsets &filteredResult : filteredResults)
+			result.append(filteredResult);
+		return result;
 	}
 }
 
+template<typename INDEX_T>
+void PetricksMethod<INDEX_T>::ExpansionStatistics::print(const std::string &functionName) const
+{
+	std::size_t peakProducts = initialProducts;
+	for (const Round &round : rounds)
+		peakProducts = std::max(peakProducts, round.allProducts);
+	const auto cerr = Progress::cerr();
+	cerr << "Expansion of \"" << functionName << "\" - sums: " << sumCount << ", rounds: " << rounds.size() << ", peak products in all sums: " << peakProducts << '\n';
+	for (std::size_t i = 0; i != rounds.size(); ++i)
+		cerr << "    Round " << (i + 1) << " - pairs: " << rounds[i].multiplications << ", products: " << rounds[i].inputProducts << " -> " << rounds[i].outputProducts << " (largest: " << rounds[i].largestOutput << "), products in all sums: " << rounds[i].allProducts << '\n';
+}
+
 template<typename INDEX_T>
 std::string PetricksMethod<INDEX_T>::ld2integerString(const long double value)
 {
@@ -165,60 +390,172 @@ std::string PetricksMethod<INDEX_T>::ld2integerString(const long double value)
 }
 
 template<typename INDEX_T>
-typename PetricksMethod<INDEX_T>::sumOfProducts_t PetricksMethod<INDEX_T>::findSumOfProducts(const std::string &functionName) const
+template<typename SUM_OF_PRODUCTS_T>
+void PetricksMethod<INDEX_T>::estimateExpansion(const std::vector<SUM_OF_PRODUCTS_T> &productOfSumsOfProducts, long double &operations, long double &solutions)
+{
+	// The worst case is assumed, i.e. that no product is ever removed as a superset of another one.
+	std::vector<long double> sizes;
+	sizes.reserve(productOfSumsOfProducts.size());
+	for (const SUM_OF_PRODUCTS_T &sum : productOfSumsOfProducts)
+		sizes.push_back(static_cast<long double>(sum.size()));
+	operations = 0.0;
+	while (sizes.size() > 1)
+	{
+		for (std::size_t i = 0; i != sizes.size() / 2; ++i)
+		{
+			sizes[i] = sizes[2 * i] * sizes[2 * i + 1];
+			operations += sizes[i];
+		}
+		if (sizes.size() % 2 != 0)
+			sizes[sizes.size() / 2] = sizes.back();
+		sizes.resize((sizes.size() + 1) / 2);
+	}
+	solutions = sizes.empty() ? 0.0 : sizes.front();
+}
+
+template<typename INDEX_T>
+template<typename SUM_OF_PRODUCTS_T>
+SUM_OF_PRODUCTS_T PetricksMethod<INDEX_T>::multiplyAll(std::vector<SUM_OF_PRODUCTS_T> &&productOfSumsOfProducts, const std::string &functionName)
 {
-	productOfSumsOfProducts_t productOfSumsOfProducts = createProductOfSums(functionName);
-	if (productOfSumsOfProducts.empty())
-		return sumOfProducts_t{};
-	
 	const std::string progressName = "Solving \"" + functionName + '"';
 	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
 	char progressInfo[128] = ""; // 128 should be enough even if the number is huge.
-	long double actualOperations = 0.0, expectedOperations = 0.0, expectedSolutions = 0.0;
 	const auto infoGuard = progress.addInfo(progressInfo);
 	progress.step();
+	ExpansionProgress expansionProgress(progress);
+	const auto stageInfoGuard = progress.addInfo(expansionProgress.getStage());
+	const std::size_t maxThreadCount = options::jobs.getValue();
+	ExpansionStatistics statistics{productOfSumsOfProducts.size(), 0, {}};
+	for (const SUM_OF_PRODUCTS_T &sum : productOfSumsOfProducts)
+		statistics.initialProducts += sum.size();
 	
+	// The sums are multiplied in pairs as a balanced tree, so the pairs of each round are independent of each other.
+	// Neighbouring sums are multiplied together, so the order given by `orderSums` is kept from round to round.
+	// A round with many pairs runs them in parallel. Otherwise, the threads split the work inside each multiplication.
 	while (productOfSumsOfProducts.size() != 1)
 	{
 		if (progress.isVisible())
 		{
-			expectedSolutions = 0.0;
-			expectedSolutions = 0.0;
-			expectedSolutions = static_cast<long double>(productOfSumsOfProducts.back().size());
-			for (auto iter = std::next(productOfSumsOfProducts.crbegin()); iter != productOfSumsOfProducts.crend(); ++iter)
-			{
-				expectedSolutions *= iter->size();
-				expectedOperations += expectedSolutions;
-			}
+			long double remainingOperations, expectedSolutions;
+			estimateExpansion(productOfSumsOfProducts, remainingOperations, expectedSolutions);
+			expansionProgress.expectedOperations = expansionProgress.getOperations() + remainingOperations;
 			std::strcpy(progressInfo, ld2integerString(expectedSolutions).c_str());
 			std::strcat(progressInfo, " solutions");
 		}
-		sumOfProducts_t multiplier0 = std::move(productOfSumsOfProducts.back());
-		productOfSumsOfProducts.pop_back();
-		sumOfProducts_t multiplier1 = std::move(productOfSumsOfProducts.back());
-		productOfSumsOfProducts.pop_back();
-		if (progress.isVisible())
+		const std::size_t pairCount = productOfSumsOfProducts.size() / 2;
+		typename ExpansionStatistics::Round &roundStatistics = statistics.rounds.emplace_back(typename ExpansionStatistics::Round{pairCount, 0, 0, 0, 0});
+		for (std::size_t i = 0; i != pairCount * 2; ++i)
+			roundStatistics.inputProducts += productOfSumsOfProducts[i].size();
+		const std::size_t threadCount = std::min(maxThreadCount, pairCount);
+		if (threadCount > 1)
 		{
-			const std::uintmax_t expectedResultSize = static_cast<std::uintmax_t>(multiplier0.size()) * static_cast<std::uintmax_t>(multiplier1.size());
-			productOfSumsOfProducts.emplace_back(multiplySumsOfProducts(std::move(multiplier0), std::move(multiplier1), actualOperations, expectedOperations, progress));
-			const std::size_t actualResultSize = productOfSumsOfProducts.back().size();
-			expectedOperations = (expectedOperations - actualOperations) * (static_cast<long double>(actualResultSize) / static_cast<long double>(expectedResultSize)) + actualOperations;
-			expectedSolutions = expectedSolutions / expectedResultSize * actualResultSize;
+			expansionProgress.concurrent = true;
+			std::atomic<std::size_t> nextPair = 0;
+			runInParallel(threadCount, [&productOfSumsOfProducts, &expansionProgress, &nextPair, pairCount](const std::size_t){
+					for (std::size_t i = nextPair++; i < pairCount; i = nextPair++)
+						productOfSumsOfProducts[2 * i] = multiplySumsOfProducts(productOfSumsOfProducts[2 * i], productOfSumsOfProducts[2 * i + 1], 1, expansionProgress);
+				});
+			expansionProgress.concurrent = false;
 		}
 		else
 		{
-			productOfSumsOfProducts.emplace_back(multiplySumsOfProducts(std::move(multiplier0), std::move(multiplier1), actualOperations, expectedOperations, progress));
+			for (std::size_t i = 0; i != pairCount; ++i)
+				productOfSumsOfProducts[2 * i] = multiplySumsOfProducts(productOfSumsOfProducts[2 * i], productOfSumsOfProducts[2 * i + 1], maxThreadCount, expansionProgress);
+		}
+		for (std::size_t i = 1; i != pairCount; ++i)
+			productOfSumsOfProducts[i] = std::move(productOfSumsOfProducts[2 * i]);
+		if (productOfSumsOfProducts.size() % 2 != 0)
+			productOfSumsOfProducts[pairCount] = std::move(productOfSumsOfProducts.back());
+		productOfSumsOfProducts.erase(productOfSumsOfProducts.begin() + static_cast<std::ptrdiff_t>(pairCount + productOfSumsOfProducts.size() % 2), productOfSumsOfProducts.end());
+		for (std::size_t i = 0; i != productOfSumsOfProducts.size(); ++i)
+		{
+			const std::size_t size = productOfSumsOfProducts[i].size();
+			if (i < pairCount)
+			{
+				roundStatistics.outputProducts += size;
+				roundStatistics.largestOutput = std::max(roundStatistics.largestOutput, size);
+			}
+			roundStatistics.allProducts += size;
 		}
 	}
 	
+	if (options::statistics.isRaised())
+		statistics.print(functionName);
 	return std::move(productOfSumsOfProducts.front());
 }
 
+template<typename INDEX_T>
+typename PetricksMethod<INDEX_T>::sumOfProducts_t PetricksMethod<INDEX_T>::findSumOfProducts(productOfSumsOfProducts_t &&productOfSumsOfProducts, const std::string &functionName) const
+{
+	if (productOfSumsOfProducts.empty())
+		return sumOfProducts_t{};
+	
+	orderSums(productOfSumsOfProducts);
+	
+	// Bitsets are much faster in practice but each product takes a whole bitset, so very wide ones are left to the Hasse diagram.
+	const options::ProductStore productStore = options::productStore.getValue();
+	const bool useBitsets = productStore == options::ProductStore::BITSETS
+			|| (productStore == options::ProductStore::AUTO && primeImplicants.size() <= MAX_AUTO_BITSET_PRIME_IMPL_COUNT);
+	sumOfProducts_t sumOfProducts;
+	if (useBitsets)
+	{
+		std::vector<ProductBitsets> productOfSums;
+		productOfSums.reserve(productOfSumsOfProducts.size());
+		for (const sumOfProducts_t &sum : productOfSumsOfProducts)
+		{
+			ProductBitsets &bitsets = productOfSums.emplace_back(primeImplicants.size());
+			bitsets.reserve(sum.size());
+			for (const product_t &product : sum)
+				bitsets.pushSingleton(product.front());
+		}
+		productOfSumsOfProducts.clear();
+		const ProductBitsets bitsets = multiplyAll(std::move(productOfSums), functionName);
+		sumOfProducts.reserve(bitsets.size());
+		for (std::size_t i = 0; i != bitsets.size(); ++i)
+			sumOfProducts.push_back(map_vector<index_t>(bitsets.listBits(i), [](const std::size_t bit){ return static_cast<index_t>(bit); }));
+	}
+	else
+	{
+		sumOfProducts = multiplyAll(std::move(productOfSumsOfProducts), functionName);
+	}
+	// Both stores return the products in their own order, so they are sorted to make the result independent of the choice.
+	// The order breaks ties when the best solution of each function is elected. (It is not the order of the original Hasse diagram, which followed the insertions and so the order of the multiplications.)
+	std::sort(sumOfProducts.begin(), sumOfProducts.end());
+	return sumOfProducts;
+}
+
+template<typename INDEX_T>
+typename PetricksMethod<INDEX_T>::sumOfProducts_t PetricksMethod<INDEX_T>::findMinimalCovers(const productOfSumsOfProducts_t &productOfSumsOfProducts, const primeImplicants_t &essentials, const std::string &functionName) const
+{
+	if (productOfSumsOfProducts.empty())
+		return sumOfProducts_t{};
+	
+	typename MinimalCoverSearch<index_t>::rows_t rows;
+	rows.reserve(productOfSumsOfProducts.size());
+	for (const sumOfProducts_t &sum : productOfSumsOfProducts)
+		rows.push_back(map_vector<index_t>(sum, [](const product_t &product){ return product.front(); }));
+	Implicant::mask_t essentialsFalseBits = 0;
+	for (const Implicant &essential : essentials)
+		essentialsFalseBits |= essential.getFalseBits();
+	
+	const std::string progressName = "Searching for the cheapest covers of \"" + functionName + '"';
+	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), 1);
+	progress.step();
+	return MinimalCoverSearch<index_t>(primeImplicants, rows, options::costSlack.getValue(), progress).find(essentialsFalseBits);
+}
+
 template<typename INDEX_T>
 Solutions PetricksMethod<INDEX_T>::solve(const std::string &functionName)
 {
-	primeImplicants_t essentials = extractEssentials(functionName);
-	sumOfProducts_t sumOfProducts = findSumOfProducts(functionName);
+	CoverageTable table = createCoverageTable(functionName);
+	primeImplicants_t essentials = extractEssentials(table, functionName);
+	removeRedundantRows(table, functionName);
+	if (options::reduce.getValue())
+		reduceToCyclicCore(table, essentials, functionName);
+	productOfSumsOfProducts_t productOfSums = createProductOfSums(table);
+	sumOfProducts_t sumOfProducts = options::coverMethod.getValue() == options::CoverMethod::BRANCH_AND_BOUND
+		? findMinimalCovers(productOfSums, essentials, functionName)
+		: findSumOfProducts(std::move(productOfSums), functionName);
 	
 	if (sumOfProducts.empty())
 		return !essentials.empty()
@@ -242,4 +579,3 @@ Solutions PetricksMethod<INDEX_T>::solve(const std::string &functionName)
 template class PetricksMethod<std::uint8_t>;
 template class PetricksMethod<std::uint16_t>;
 template class PetricksMethod<std::uint32_t>;
-template class PetricksMethod<std::uint64_t>;
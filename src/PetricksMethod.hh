@@ -1,14 +1,20 @@
 #pragma once
 
+#include <atomic>
 #include <cstddef>
-#include <set>
+#include <cstdint>
+#include <cstring>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "CoverageTable.hh"
 #include "Minterm.hh"
+#include "Minterms.hh"
 #include "HasseDiagram.hh"
 #include "Implicant.hh"
+#include "MinimalCoverSearch.hh"
+#include "ProductBitsets.hh"
 #include "Progress.hh"
 #include "Solution.hh"
 #include "Solutions.hh"
@@ -18,29 +24,75 @@ template<typename INDEX_T>
 class PetricksMethod
 {
 public:
-	using minterms_t = std::set<Minterm>;
+	using minterms_t = Minterms;
 	using primeImplicants_t = std::vector<Implicant>;
 	
 private:
 	using index_t = INDEX_T;
-	static constexpr index_t NO_INDEX = static_cast<index_t>(~index_t(0));
 	using product_t = std::vector<index_t>;
 	using sumOfProducts_t = std::vector<product_t>;
 	using productOfSumsOfProducts_t = std::vector<sumOfProducts_t>;
+	static constexpr std::size_t MAX_AUTO_BITSET_PRIME_IMPL_COUNT = 1024;
+	static constexpr std::size_t MIN_OPERATIONS_PER_THREAD = 4096;
+	
+	// Progress of the expansion of the product of sums. It may be shared by many threads that multiply sums at the same time.
+	class ExpansionProgress
+	{
+		Progress &progress;
+		std::atomic<std::uintmax_t> operations = 0;
+		const Progress::calcStepCompletion_t calcCompletion;
+		char stage[16] = "expanding";
+	
+	public:
+		long double expectedOperations = 1.0;
+		bool concurrent = false;
+		
+		explicit ExpansionProgress(Progress &progress) : progress(progress), calcCompletion([this](){ return static_cast<Progress::completion_t>(getOperations() / expectedOperations); }) {}
+		
+		[[nodiscard]] const char* getStage() const { return stage; }
+		// The stage is shown only when the sums are multiplied one at a time. (Otherwise, each thread would be in a different stage.)
+		void setStage(const char newStage[]) { if (!concurrent) std::strcpy(stage, newStage); }
+		[[nodiscard]] long double getOperations() const { return static_cast<long double>(operations.load(std::memory_order_relaxed)); }
+		void addOperations(const std::uintmax_t count) { operations.fetch_add(count, std::memory_order_relaxed); }
+		void substep(const bool force = false) { if (concurrent) progress.concurrentSubstep(calcCompletion); else progress.substep(calcCompletion, force); }
+	};
 	
 	minterms_t minterms;
 	primeImplicants_t primeImplicants;
 	
 	PetricksMethod(minterms_t &&minterms, primeImplicants_t &&primeImplicants) : minterms(std::move(minterms)), primeImplicants(std::move(primeImplicants)) {}
 	
-	index_t findEssentialPrimeImplicantIndex(const Minterm minterm);
-	primeImplicants_t extractEssentials(const std::string &functionName);
-	productOfSumsOfProducts_t createPreliminaryProductOfSums(const std::string &functionName) const;
-	static void removeRedundantSums(productOfSumsOfProducts_t &productOfSums, const std::string &functionName);
-	productOfSumsOfProducts_t createProductOfSums(const std::string &functionName) const;
-	static sumOfProducts_t multiplySumsOfProducts(const sumOfProducts_t &multiplier0, const sumOfProducts_t &multiplier1, long double &actualOperations, const long double expectedOperations, Progress &progress);
+	CoverageTable createCoverageTable(const std::string &functionName) const;
+	primeImplicants_t extractEssentials(CoverageTable &table, const std::string &functionName);
+	static void removeRedundantRows(CoverageTable &table, const std::string &functionName);
+	bool extractSecondaryEssentials(CoverageTable &table, primeImplicants_t &essentials) const;
+	bool removeDominatedPrimeImplicants(CoverageTable &table) const;
+	void reduceToCyclicCore(CoverageTable &table, primeImplicants_t &essentials, const std::string &functionName) const;
+	static productOfSumsOfProducts_t createProductOfSums(const CoverageTable &table);
+	void orderSums(productOfSumsOfProducts_t &productOfSumsOfProducts) const;
+	// Sizes of the intermediate results of the expansion, printed with `--statistics`.
+	struct ExpansionStatistics
+	{
+		struct Round
+		{
+			std::size_t multiplications, inputProducts, outputProducts, largestOutput, allProducts;
+		};
+		std::size_t sumCount, initialProducts;
+		std::vector<Round> rounds;
+		
+		void print(const std::string &functionName) const;
+	};
+	
+	static std::size_t calcThreadCount(const std::size_t maxThreadCount, const std::size_t multiplier0Size, const std::size_t multiplier1Size);
+	static sumOfProducts_t multiplySumsOfProducts(const sumOfProducts_t &multiplier0, const sumOfProducts_t &multiplier1, const std::size_t maxThreadCount, ExpansionProgress &expansionProgress);
+	static ProductBitsets multiplySumsOfProducts(const ProductBitsets &multiplier0, const ProductBitsets &multiplier1, const std::size_t maxThreadCount, ExpansionProgress &expansionProgress);
 	static std::string ld2integerString(const long double value);
-	sumOfProducts_t findSumOfProducts(const std::string &functionName) const;
+	template<typename SUM_OF_PRODUCTS_T>
+	static void estimateExpansion(const std::vector<SUM_OF_PRODUCTS_T> &productOfSumsOfProducts, long double &operations, long double &solutions);
+	template<typename SUM_OF_PRODUCTS_T>
+	static SUM_OF_PRODUCTS_T multiplyAll(std::vector<SUM_OF_PRODUCTS_T> &&productOfSumsOfProducts, const std::string &functionName);
+	sumOfProducts_t findSumOfProducts(productOfSumsOfProducts_t &&productOfSumsOfProducts, const std::string &functionName) const;
+	sumOfProducts_t findMinimalCovers(const productOfSumsOfProducts_t &productOfSumsOfProducts, const primeImplicants_t &essentials, const std::string &functionName) const;
 	Solutions solve(const std::string &functionName);
 	
 public:
@@ -0,0 +1,108 @@
+#include "./ProductBitsets.hh"
+
+#include <algorithm>
+#include <bitset>
+#include <numeric>
+
+
+std::size_t ProductBitsets::countBits(const word_t *const product, const std::size_t wordCount)
+{
+	std::size_t count = 0;
+	for (std::size_t i = 0; i != wordCount; ++i)
+		count += std::bitset<WORD_BITS>(product[i]).count();
+	return count;
+}
+
+bool ProductBitsets::isSubset(const word_t *const subset, const word_t *const superset, const std::size_t wordCount)
+{
+	word_t difference = 0;
+	for (std::size_t i = 0; i != wordCount; ++i)
+		difference |= subset[i] & ~superset[i];
+	return difference == 0;
+}
+
+std::vector<std::size_t> ProductBitsets::listBits(const std::size_t i) const
+{
+	std::vector<std::size_t> bits;
+	const word_t *const product = (*this)[i];
+	for (std::size_t j = 0; j != wordsPerProduct; ++j)
+		for (word_t word = product[j]; word != 0; word &= word - 1)
+			bits.push_back(j * WORD_BITS + std::bitset<WORD_BITS>((word & (~word + 1)) - 1).count());
+	return bits;
+}
+
+bool ProductBitsets::containsSubset(const word_t *const product) const
+{
+	for (std::size_t i = 0; i != size(); ++i)
+		if (isSubset((*this)[i], product, wordsPerProduct))
+			return true;
+	return false;
+}
+
+bool ProductBitsets::containsProperSubset(const word_t *const product) const
+{
+	for (std::size_t i = 0; i != size(); ++i)
+		if (isSubset((*this)[i], product, wordsPerProduct) && !std::equal(product, product + wordsPerProduct, (*this)[i]))
+			return true;
+	return false;
+}
+
+void ProductBitsets::pushSingleton(const std::size_t bit)
+{
+	words.resize(words.size() + wordsPerProduct, 0);
+	words[words.size() - wordsPerProduct + bit / WORD_BITS] = word_t(1) << (bit % WORD_BITS);
+}
+
+void ProductBitsets::pushUnion(const word_t *const x, const word_t *const y)
+{
+	for (std::size_t i = 0; i != wordsPerProduct; ++i)
+		words.push_back(x[i] | y[i]);
+}
+
+void ProductBitsets::removeSupersets()
+{
+	// Products are visited from the smallest ones, so a product can only be a superset of the ones that were already kept.
+	// Two different products of the same size are never subsets of each other, so only the smaller kept ones need to be checked.
+	const std::size_t productCount = size();
+	std::vector<std::size_t> sizes(productCount), order(productCount);
+	for (std::size_t i = 0; i != productCount; ++i)
+		sizes[i] = countBits((*this)[i], wordsPerProduct);
+	std::iota(order.begin(), order.end(), std::size_t(0));
+	std::sort(order.begin(), order.end(), [this, &sizes](const std::size_t x, const std::size_t y){
+			if (sizes[x] != sizes[y])
+				return sizes[x] < sizes[y];
+			return std::lexicographical_compare((*this)[x], (*this)[x] + wordsPerProduct, (*this)[y], (*this)[y] + wordsPerProduct);
+		});
+	
+	std::vector<word_t> keptWords;
+	std::size_t keptCount = 0, keptSmallerCount = 0, currentSize = 0;
+	const word_t *previous = nullptr;
+	for (const std::size_t i : order)
+	{
+		const word_t *const product = (*this)[i];
+		if (sizes[i] != currentSize)
+		{
+			currentSize = sizes[i];
+			keptSmallerCount = keptCount;
+		}
+		else if (previous != nullptr && std::equal(product, product + wordsPerProduct, previous))
+		{
+			continue;
+		}
+		previous = product;
+		bool isSuperset = false;
+		for (std::size_t j = 0; j != keptSmallerCount; ++j)
+		{
+			if (isSubset(keptWords.data() + j * wordsPerProduct, product, wordsPerProduct))
+			{
+				isSuperset = true;
+				break;
+			}
+		}
+		if (isSuperset)
+			continue;
+		keptWords.insert(keptWords.end(), product, product + wordsPerProduct);
+		++keptCount;
+	}
+	words = std::move(keptWords);
+}
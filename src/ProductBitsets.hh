@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+
+// A list of products of prime implicants where every product is a bitset of fixed width, stored in one continuous array.
+// Union is a word-wise OR and a subset test is a word-wise AND, so it is a much lighter alternative to `HasseDiagram` when the number of prime implicants is small.
+class ProductBitsets
+{
+public:
+	using word_t = std::uint64_t;
+	static constexpr std::size_t WORD_BITS = 64;
+	
+private:
+	std::size_t bitCount, wordsPerProduct;
+	std::vector<word_t> words;
+	
+	[[nodiscard]] static std::size_t countBits(const word_t *const product, const std::size_t wordCount);
+	[[nodiscard]] static bool isSubset(const word_t *const subset, const word_t *const superset, const std::size_t wordCount);
+	
+public:
+	explicit ProductBitsets(const std::size_t bitCount) : bitCount(bitCount), wordsPerProduct((bitCount + WORD_BITS - 1) / WORD_BITS) {}
+	
+	[[nodiscard]] std::size_t getBitCount() const { return bitCount; }
+	[[nodiscard]] std::size_t size() const { return wordsPerProduct == 0 ? 0 : words.size() / wordsPerProduct; }
+	[[nodiscard]] bool empty() const { return words.empty(); }
+	[[nodiscard]] const word_t* operator[](const std::size_t i) const { return words.data() + i * wordsPerProduct; }
+	[[nodiscard]] std::vector<std::size_t> listBits(const std::size_t i) const;
+	
+	// Both are safe to call from many threads at once as long as the list is not modified.
+	[[nodiscard]] bool containsSubset(const word_t *const product) const;
+	[[nodiscard]] bool containsProperSubset(const word_t *const product) const;
+	
+	void reserve(const std::size_t productCount) { words.reserve(productCount * wordsPerProduct); }
+	void push(const word_t *const product) { words.insert(words.end(), product, product + wordsPerProduct); }
+	void pushSingleton(const std::size_t bit);
+	void pushUnion(const word_t *const x, const word_t *const y);
+	void append(const ProductBitsets &other) { words.insert(words.end(), other.words.cbegin(), other.words.cend()); }
+	void removeSupersets();
+};
@@ -5,6 +5,7 @@
 #include <cmath>
 #include <iomanip>
 #include <ios>
+#include <iterator>
 #include <stdexcept>
 
 #include "options.hh"
@@ -12,9 +13,9 @@
 
 Progress::calcStepCompletion_t Progress::calc0StepCompletion = [](){ return 0.0; };
 
-std::uint_fast8_t Progress::stageCounters[STAGE_COUNT] = {};
+thread_local std::uint_fast8_t Progress::stageCounters[STAGE_COUNT] = {};
 
-Progress *Progress::progress = nullptr;
+thread_local Progress *Progress::progress = nullptr;
 Progress::timePoint_t Progress::programStartTime;
 
 Progress::steps_t Progress::calcStepsToSkip(const double secondsToSkip, const double secondsPerStep) const
@@ -204,6 +205,11 @@ void Progress::init()
 	programStartTime = std::chrono::steady_clock::now();
 }
 
+void Progress::resetStages()
+{
+	std::fill(std::begin(stageCounters), std::end(stageCounters), 0);
+}
+
 Progress::Progress(const Stage stage, const char processName[], const steps_t allSteps, const bool relatedSteps, const bool visible) :
 	stage(stage),
 	processName(processName),
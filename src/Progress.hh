@@ -5,6 +5,7 @@
 #include <cstdint>
 #include <functional>
 #include <iostream>
+#include <mutex>
 #include <string_view>
 #include <utility>
 #include <vector>
@@ -30,13 +31,13 @@ public:
 	
 private:
 	static constexpr std::size_t STAGE_COUNT = 3;
-	static std::uint_fast8_t stageCounters[STAGE_COUNT];
+	static thread_local std::uint_fast8_t stageCounters[STAGE_COUNT];
 	
 	using timePoint_t = std::chrono::steady_clock::time_point;
 	
 	static constexpr double reportInterval = 1.0;
 	
-	static Progress *progress;
+	static thread_local Progress *progress;
 	static timePoint_t programStartTime;
 	
 	const Stage stage;
@@ -50,6 +51,7 @@ private:
 	bool visible;
 	std::vector<const char*> infoTexts;
 	std::uint_fast8_t reportLines = 0;
+	std::mutex substepMutex;
 	
 	steps_t calcStepsToSkip(const double secondsToSkip, const double secondsPerStep) const;
 	static double getSecondsSinceStart(const timePoint_t currentTime);
@@ -65,6 +67,7 @@ private:
 	
 public:
 	static void init();
+	static void resetStages();  // Used between problems in batch mode.
 	
 	class CerrGuard
 	{
@@ -115,7 +118,10 @@ public:
 	[[nodiscard]] static CerrGuard cerr() { return {progress}; }
 	
 	void step(const bool force = false);
+	void skipSteps(const steps_t count) { if (visible) stepsSoFar += count; }
 	void substep(const calcStepCompletion_t &calcStepCompletion, const bool force = false) { if (visible) { if (--substepsToSkip == 0 || force) handleStep(calcStepCompletion, force); ++substepsSoFar; } }
+	// A variant of `substep` that is safe to call from many threads at once. (If another thread is in the middle of a substep, this one is just skipped.)
+	void concurrentSubstep(const calcStepCompletion_t &calcStepCompletion) { if (visible) { const std::unique_lock lock(substepMutex, std::try_to_lock); if (lock.owns_lock()) substep(calcStepCompletion); } }
 	template<typename T = std::size_t>
 	[[nodiscard]] CountingStepHelper<T> makeCountingStepHelper(const completion_t n) { return {*this, n}; }
 	
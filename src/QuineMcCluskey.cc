@@ -1,62 +1,236 @@
 #include "./QuineMcCluskey.hh"
 
+#include <algorithm>
+#include <atomic>
 #include <cstdint>
 #include <cstring>
 #include <iostream>
 #include <set>
 #include <string>
+#include <utility>
 
+#include "ImplicantHashTable.hh"
 #include "options.hh"
 #include "Progress.hh"
+#include "TimeLimit.hh"
+#include "utils.hh"
 
 
-QuineMcCluskey::primeImplicants_t QuineMcCluskey::findPrimeImplicants(const Minterms &allowedMinterms, const std::string &functionName) const
+QuineMcCluskey::buckets_t QuineMcCluskey::makeBuckets(const implicants_t &implicants, std::vector<std::size_t> &order)
+{
+	// Two implicants can be merged only if they have the same mask and their numbers of true bits differ by one. Grouping them by those two properties lets us compare only the neighboring groups.
+	order.resize(implicants.size());
+	for (std::size_t i = 0; i != order.size(); ++i)
+		order[i] = i;
+	const auto getKey = [&implicants](const std::size_t index){ return std::make_pair(implicants[index].first.getMask(), implicants[index].first.getTrueBitCount()); };
+	std::sort(order.begin(), order.end(), [&getKey](const std::size_t x, const std::size_t y){ return getKey(x) < getKey(y); });
+	
+	buckets_t buckets;
+	for (std::size_t i = 0; i != order.size();)
+	{
+		const auto [mask, trueBitCount] = getKey(order[i]);
+		const std::size_t begin = i;
+		for (++i; i != order.size() && getKey(order[i]) == std::make_pair(mask, trueBitCount); ++i) {}
+		buckets.push_back({mask, trueBitCount, begin, i});
+	}
+	return buckets;
+}
+
+std::vector<Implicant> QuineMcCluskey::mergeInBuckets(implicants_t &implicants, Progress &progress)
+{
+	std::vector<std::size_t> order;
+	const buckets_t buckets = makeBuckets(implicants, order);
+	const auto areNeighbors = [](const Bucket &x, const Bucket &y){ return x.mask == y.mask && x.trueBitCount + 1 == y.trueBitCount; };
+	
+	std::uintmax_t operationsSoFar = 0, expectedOperations = 0;
+	if (progress.isVisible())
+		for (auto iter = buckets.cbegin(); iter != buckets.cend() && std::next(iter) != buckets.cend(); ++iter)
+			if (areNeighbors(*iter, *std::next(iter)))
+				expectedOperations += static_cast<std::uintmax_t>(iter->end - iter->begin) * static_cast<std::uintmax_t>(std::next(iter)->end - std::next(iter)->begin);
+	const Progress::calcStepCompletion_t calcStepCompletion = [&operationsSoFar = std::as_const(operationsSoFar), expectedOperations](){ return static_cast<Progress::completion_t>(operationsSoFar) / static_cast<Progress::completion_t>(expectedOperations); };
+	
+	std::set<Implicant> newImplicants;
+	for (auto bucket = buckets.cbegin(); bucket != buckets.cend() && std::next(bucket) != buckets.cend(); ++bucket)
+	{
+		const Bucket &nextBucket = *std::next(bucket);
+		if (!areNeighbors(*bucket, nextBucket))
+			continue;
+		for (std::size_t i = bucket->begin; i != bucket->end && !TimeLimit::isUp(); ++i)
+		{
+			progress.substep(calcStepCompletion);
+			operationsSoFar += nextBucket.end - nextBucket.begin;
+			auto &[x, xMerged] = implicants[order[i]];
+			for (std::size_t j = nextBucket.begin; j != nextBucket.end; ++j)
+			{
+				auto &[y, yMerged] = implicants[order[j]];
+				if (Implicant::areMergeable(x, y))
+				{
+					newImplicants.insert(Implicant::merge(x, y));
+					xMerged = true;
+					yMerged = true;
+				}
+			}
+		}
+	}
+	return {newImplicants.cbegin(), newImplicants.cend()};
+}
+
+std::vector<Implicant> QuineMcCluskey::mergeUsingHashTable(implicants_t &implicants, Progress &progress)
+{
+	ImplicantHashTable currentImplicants(implicants.size());
+	for (const auto &implicant : implicants)
+		currentImplicants.insert(implicant.first);
+	
+	static constexpr std::size_t minImplicantsPerThread = 1024;
+	const std::size_t threadCount = std::min<std::size_t>(options::jobs.getValue(), (implicants.size() + minImplicantsPerThread - 1) / minImplicantsPerThread);
+	
+	std::atomic<std::size_t> implicantsSoFar = 0;
+	const Progress::calcStepCompletion_t calcStepCompletion = [&implicantsSoFar, n = static_cast<Progress::completion_t>(implicants.size())](){ return static_cast<Progress::completion_t>(implicantsSoFar.load(std::memory_order_relaxed)) / n; };
+	
+	std::vector<ImplicantHashTable> newImplicantsPerThread;
+	newImplicantsPerThread.reserve(threadCount);
+	for (std::size_t i = 0; i != threadCount; ++i)
+		newImplicantsPerThread.emplace_back(implicants.size() / 2 / threadCount);
+	std::vector<std::vector<std::size_t>> mergedPartnersPerThread(threadCount);
+	runInParallel(threadCount, [&](const std::size_t threadIndex){
+			ImplicantHashTable &newImplicants = newImplicantsPerThread[threadIndex];
+			std::vector<std::size_t> &mergedPartners = mergedPartnersPerThread[threadIndex];
+			const std::size_t begin = implicants.size() * threadIndex / threadCount, end = implicants.size() * (threadIndex + 1) / threadCount;
+			for (std::size_t i = begin; i != end && !TimeLimit::isUp(); ++i)
+			{
+				if (progress.isVisible())
+				{
+					implicantsSoFar.fetch_add(1, std::memory_order_relaxed);
+					progress.concurrentSubstep(calcStepCompletion);
+				}
+				auto &[x, xMerged] = implicants[i];
+				// Each pair is found only once - from the side of the implicant that has the differing bit negated.
+				for (Implicant::mask_t falseBits = x.getFalseBits(); falseBits != 0; falseBits &= falseBits - 1)
+				{
+					const Implicant::mask_t bit = falseBits & -falseBits;
+					if (const std::size_t yIndex = currentImplicants.find(x.withFlippedBit(bit)); yIndex != ImplicantHashTable::NOT_FOUND)
+					{
+						newImplicants.insert(Implicant::merge(x, implicants[yIndex].first));
+						xMerged = true;
+						mergedPartners.push_back(yIndex); // The partner may belong to another thread, so its flag is set after all of them finish.
+					}
+				}
+			}
+		});
+	
+	for (const std::vector<std::size_t> &mergedPartners : mergedPartnersPerThread)
+		for (const std::size_t yIndex : mergedPartners)
+			implicants[yIndex].second = true;
+	
+	// The order has to be the same as in the other method to produce the same list of prime implicants.
+	std::vector<Implicant> sortedNewImplicants;
+	if (threadCount == 1)
+	{
+		sortedNewImplicants = newImplicantsPerThread.front().releaseImplicants();
+		std::sort(sortedNewImplicants.begin(), sortedNewImplicants.end());
+	}
+	else
+	{
+		std::size_t totalSize = 0;
+		for (const ImplicantHashTable &newImplicants : newImplicantsPerThread)
+			totalSize += newImplicants.getSize();
+		sortedNewImplicants.reserve(totalSize);
+		for (ImplicantHashTable &newImplicants : newImplicantsPerThread)
+		{
+			const ImplicantHashTable::implicants_t threadImplicants = newImplicants.releaseImplicants();
+			sortedNewImplicants.insert(sortedNewImplicants.end(), threadImplicants.cbegin(), threadImplicants.cend());
+		}
+		std::sort(sortedNewImplicants.begin(), sortedNewImplicants.end());
+		sortedNewImplicants.erase(std::unique(sortedNewImplicants.begin(), sortedNewImplicants.end()), sortedNewImplicants.end());
+	}
+	return sortedNewImplicants;
+}
+
+std::vector<Implicant> QuineMcCluskey::findIsolatedCubes(const Minterms &allowedMinterms, std::vector<Implicant> cubes)
+{
+	// A cube is isolated when none of its minterms has a neighbor outside of it (i.e. with one of the cube's fixed bits flipped) that is allowed.
+	// Every implicant that overlaps such a cube is contained in it, so the cube is a prime implicant and its minterms don't take part in any other merges.
+	std::sort(cubes.begin(), cubes.end());
+	cubes.erase(std::unique(cubes.begin(), cubes.end()), cubes.end());
+	// Flipping one fixed bit of the whole cube gives all such neighbors at once.
+	const auto isIsolated = [&allowedMinterms](const Implicant &cube){
+			for (Implicant::mask_t bits = cube.getMask(); bits != 0; bits &= bits - 1)
+				if (allowedMinterms.intersects(cube.withFlippedBit(bits & -bits)))
+					return false;
+			return true;
+		};
+	cubes.erase(std::remove_if(cubes.begin(), cubes.end(), [&isIsolated](const Implicant &cube){ return !isIsolated(cube); }), cubes.end());
+	return cubes;
+}
+
+QuineMcCluskey::primeImplicants_t QuineMcCluskey::findPrimeImplicants(const Minterms &allowedMinterms, const std::vector<Implicant> &cubes, const std::string &functionName, bool &cutShort) const
 {
 	const std::string progressName = "Merging implicants of \"" + functionName + '"';
 	Progress progress(Progress::Stage::SOLVING, progressName.c_str(), ::bits + 1, true);
 	
-	std::vector<std::pair<Implicant, bool>> implicants;
-	for (const Minterm &minterm : allowedMinterms)
-		implicants.emplace_back(Implicant{minterm}, false);
+	// Isolated cubes are put directly into the level of their size instead of being merged from their minterms. (The result is exactly the same.)
+	const std::vector<Implicant> isolatedCubes = findIsolatedCubes(allowedMinterms, cubes);
+	implicants_t implicants;
+	{
+		const Minterms skippedMinterms({}, isolatedCubes);
+		implicants.reserve(allowedMinterms.size() - skippedMinterms.size());
+		for (const Minterm minterm : allowedMinterms)
+			if (!skippedMinterms.contains(minterm))
+				implicants.emplace_back(Implicant{minterm}, false);
+	}
+	std::size_t cubesLeft = isolatedCubes.size();
 	
 	primeImplicants_t primeImplicants;
 	
 	::bits_t implicantSize = ::bits;
 	char subtaskDescription[96] = "";
 	const auto infoGuard = progress.addInfo(subtaskDescription);
-	while (!implicants.empty())
+	while (!implicants.empty() || cubesLeft != 0)
 	{
-		std::uintmax_t operationsSoFar = 0, expectedOperations = 0;
+		const std::size_t oldSize = implicants.size();
+		for (const Implicant &cube : isolatedCubes)
+			if (cube.getBitCount() == implicantSize)
+				implicants.emplace_back(cube, false);
+		if (implicants.size() != oldSize)
+		{
+			cubesLeft -= implicants.size() - oldSize;
+			std::sort(implicants.begin(), implicants.end(), [](const auto &x, const auto &y){ return x.first < y.first; });
+		}
+		if (implicants.empty())
+		{
+			--implicantSize;
+			continue;
+		}
+		if (TimeLimit::isUp())
+		{
+			// The implicants that are left are not prime but together with the ones found so far, they still cover every allowed minterm.
+			cutShort = true;
+			for (const auto &[implicant, merged] : implicants)
+				primeImplicants.push_back(implicant);
+			for (const Implicant &cube : isolatedCubes)
+				if (cube.getBitCount() < implicantSize)
+					primeImplicants.push_back(cube);
+			return primeImplicants;
+		}
+		
 		if (progress.isVisible())
 		{
 			std::strcpy(subtaskDescription, std::to_string(implicants.size()).c_str());
 			std::strcat(subtaskDescription, " left (");
-			std::strcat(subtaskDescription, std::to_string(implicantSize--).c_str());
+			std::strcat(subtaskDescription, std::to_string(implicantSize).c_str());
 			std::strcat(subtaskDescription, " literals each)");
-			expectedOperations = static_cast<std::uintmax_t>(implicants.size()) * static_cast<std::uintmax_t>(implicants.size() - 1) / 2;
 		}
-		const Progress::calcStepCompletion_t calcStepCompletion = [&operationsSoFar = std::as_const(operationsSoFar), expectedOperations](){ return static_cast<Progress::completion_t>(operationsSoFar) / static_cast<Progress::completion_t>(expectedOperations); };
+		--implicantSize;
 		progress.step(true);
 		
-		std::set<Implicant> newImplicants;
-		
-		for (auto iter = implicants.begin(); iter != implicants.end(); ++iter)
-		{
-			progress.substep(calcStepCompletion);
-			operationsSoFar += implicants.cend() - iter - 1;
-			for (auto jiter = std::next(iter); jiter != implicants.end(); ++jiter)
-			{
-				if (Implicant::areMergeable(iter->first, jiter->first))
-				{
-					newImplicants.insert(Implicant::merge(iter->first, jiter->first));
-					iter->second = true;
-					jiter->second = true;
-				}
-			}
-		}
+		const std::vector<Implicant> newImplicants = options::mergeMethod.getValue() == options::MergeMethod::BUCKETS
+			? mergeInBuckets(implicants, progress)
+			: mergeUsingHashTable(implicants, progress);
 		
+		// If the merging was cut short by the time limit, some of the merged implicants may be missing their merged versions, so all of them are kept.
+		const bool mergingCutShort = TimeLimit::isUp();
 		for (const auto &[implicant, merged] : implicants)
-			if (!merged)
+			if (!merged || mergingCutShort)
 				primeImplicants.push_back(implicant);
 		implicants.clear();
 		
@@ -68,17 +242,41 @@ QuineMcCluskey::primeImplicants_t QuineMcCluskey::findPrimeImplicants(const Mint
 	return primeImplicants;
 }
 
-Solutions QuineMcCluskey::solve(const Minterms &allowedMinterms, const Minterms &targetMinterms, const std::string &functionName) const
+Solutions QuineMcCluskey::findGreedyCover(const Minterms &targetMinterms, std::vector<Implicant> implicants)
+{
+	// The implicants are not all prime, so there may be too many of them for Petrick's method. Instead, the biggest ones are taken as long as they cover something new.
+	if (targetMinterms.empty())
+		return {{Implicant::error()}};
+	std::stable_sort(implicants.begin(), implicants.end(), [](const Implicant &x, const Implicant &y){ return x.getBitCount() < y.getBitCount(); });
+	Minterms uncoveredMinterms = targetMinterms;
+	Solution cover;
+	for (const Implicant &implicant : implicants)
+	{
+		if (uncoveredMinterms.empty())
+			break;
+		bool coversNew = false;
+		for (const Minterm minterm : implicant.findMinterms())
+			coversNew |= uncoveredMinterms.erase(minterm);
+		if (coversNew)
+			cover.push_back(implicant);
+	}
+	return {std::move(cover)};
+}
+
+Solutions QuineMcCluskey::solve(const Minterms &allowedMinterms, const Minterms &targetMinterms, const std::vector<Implicant> &cubes, const std::string &functionName) const
 {
-	primeImplicants_t primeImplicants = findPrimeImplicants(allowedMinterms, functionName);
+	bool cutShort = false;
+	primeImplicants_t primeImplicants = findPrimeImplicants(allowedMinterms, cubes, functionName, cutShort);
+	if (cutShort)
+		return findGreedyCover(targetMinterms, std::move(primeImplicants));
+	// The narrowest index that fits is used, so the products take as little memory as possible.
+	// (There are no 64-bit indices because nodes of `HasseDiagram` are addressed by 32-bit indices anyway.)
 	if (primeImplicants.size() <= PetricksMethod<std::uint8_t>::MAX_PRIME_IMPL_COUNT)
 		return PetricksMethod<std::uint8_t>::solve(targetMinterms, std::move(primeImplicants), functionName);
 	else if (primeImplicants.size() <= PetricksMethod<std::uint16_t>::MAX_PRIME_IMPL_COUNT)
 		return PetricksMethod<std::uint16_t>::solve(targetMinterms, std::move(primeImplicants), functionName);
 	else if (primeImplicants.size() <= PetricksMethod<std::uint32_t>::MAX_PRIME_IMPL_COUNT)
 		return PetricksMethod<std::uint32_t>::solve(targetMinterms, std::move(primeImplicants), functionName);
-	else if (primeImplicants.size() <= PetricksMethod<std::uint64_t>::MAX_PRIME_IMPL_COUNT)
-		return PetricksMethod<std::uint64_t>::solve(targetMinterms, std::move(primeImplicants), functionName);
 	else
 		std::cerr << "The number of prime implicants is ridiculous and this has no right to work! I won't even try.\n";
 	return {};
@@ -1,20 +1,36 @@
 #pragma once
 
+#include <cstddef>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "Implicant.hh"
 #include "Minterms.hh"
 #include "PetricksMethod.hh"
+#include "Progress.hh"
 #include "Solutions.hh"
 
 
 class QuineMcCluskey
 {
 	using primeImplicants_t = typename PetricksMethod<unsigned>::primeImplicants_t;
+	using implicants_t = std::vector<std::pair<Implicant, bool>>;
+	struct Bucket
+	{
+		Implicant::mask_t mask;
+		bits_t trueBitCount;
+		std::size_t begin, end;
+	};
+	using buckets_t = std::vector<Bucket>;
 	
-	primeImplicants_t findPrimeImplicants(const Minterms &allowedMinterms, const std::string &functionName) const;
+	static buckets_t makeBuckets(const implicants_t &implicants, std::vector<std::size_t> &order);
+	static std::vector<Implicant> mergeInBuckets(implicants_t &implicants, Progress &progress);
+	static std::vector<Implicant> mergeUsingHashTable(implicants_t &implicants, Progress &progress);
+	static std::vector<Implicant> findIsolatedCubes(const Minterms &allowedMinterms, std::vector<Implicant> cubes);
+	primeImplicants_t findPrimeImplicants(const Minterms &allowedMinterms, const std::vector<Implicant> &cubes, const std::string &functionName, bool &cutShort) const;
+	static Solutions findGreedyCover(const Minterms &targetMinterms, std::vector<Implicant> implicants);
 	
 public:
-	Solutions solve(const Minterms &allowedMinterms, const Minterms &targetMinterms, const std::string &functionName) const;
+	Solutions solve(const Minterms &allowedMinterms, const Minterms &targetMinterms, const std::vector<Implicant> &cubes, const std::string &functionName) const;
 };
@@ -3,6 +3,11 @@
 #include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <iterator>
+#include <tuple>
+
+#include "options.hh"
+#include "TimeLimit.hh"
 
 
 template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
@@ -10,7 +15,7 @@ typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Result SetOptimizer<SET,
 {
 	const typename SubsetFinder::setHierarchy_t setHierarchy = SubsetFinder::makeSetHierarchy(convertSets(oldSets));
 	makeGraph(setHierarchy);
-	auto [subsetSelections, usageCounts] = findBestSubsets(progress);
+	auto [subsetSelections, usageCounts] = options::cseMethod.getValue() == options::CseMethod::GREEDY ? findGreedySubsets(progress) : findBestSubsets(progress);
 	removeUnusedSubsets(subsetSelections, usageCounts);
 	sets_t newSets = makeSets();
 	const finalSets_t finalSets = makeFinalSets(oldSets, newSets);
@@ -18,6 +23,71 @@ typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Result SetOptimizer<SET,
 	return {newSets, finalSets, subsetSelections};
 }
 
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+std::optional<typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Result> SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Cache::find(const sets_t &sets)
+{
+	const std::lock_guard lock(mutex);
+	++lookupCount;
+	const auto foundResult = results.find(sets);
+	if (foundResult == results.cend())
+		return std::nullopt;
+	++hitCount;
+	return foundResult->second;
+}
+
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+void SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Cache::insert(const sets_t &sets, const Result &result)
+{
+	const std::lock_guard lock(mutex);
+	if (maxSize == 0)
+		return;
+	const auto [insertedResult, isNew] = results.emplace(sets, result);
+	if (!isNew)
+		return;
+	insertionOrder.push_back(insertedResult);
+	if (insertionOrder.size() > maxSize)
+	{
+		results.erase(insertionOrder.front());
+		insertionOrder.pop_front();
+	}
+}
+
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+void SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Cache::printStatistics(const char name[])
+{
+	const std::lock_guard lock(mutex);
+	const auto cerr = Progress::cerr();
+	cerr << "    Cache of " << name << " - lookups: " << lookupCount << ", hits: " << hitCount;
+	if (lookupCount != 0)
+		cerr << " (" << (hitCount * 100 / lookupCount) << "%)";
+	cerr << ", kept results: " << results.size() << '/' << maxSize << '\n';
+}
+
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::Result SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::extractCommonParts(const sets_t &sets, Progress &progress, Cache *const cache)
+{
+	if (cache == nullptr)
+		return extractCommonParts(sets, progress);
+	
+	// Different lists of the same sets are optimized the same way, so they share one result. (Only the order in which it lists the parts depends on the order of the sets.)
+	sets_t sortedSets = sets;
+	std::sort(sortedSets.begin(), sortedSets.end());
+	sortedSets.erase(std::unique(sortedSets.begin(), sortedSets.end()), sortedSets.end());
+	std::optional<Result> result = cache->find(sortedSets);
+	if (!result)
+	{
+		result = extractCommonParts(sortedSets, progress);
+		cache->insert(sortedSets, *result);
+	}
+	
+	finalSets_t finalSets;
+	finalSets.reserve(sets.size());
+	for (const set_t &set : sets)
+		finalSets.push_back(result->finalSets[static_cast<std::size_t>(std::distance(sortedSets.cbegin(), std::lower_bound(sortedSets.cbegin(), sortedSets.cend(), set)))]);
+	result->finalSets = std::move(finalSets);
+	return std::move(*result);
+}
+
 template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
 std::pair<Progress::completion_t, Progress::completion_t> SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::estimateCompletion(const subsetSelection_t &subsetSelection, const possibleSubsets_t &possibleSubsets)
 {
@@ -56,6 +126,9 @@ template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAI
 bool SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::chooseNextSubsets(subsetSelections_t &subsetSelections, usageCounts_t &usageCounts) const
 {
 	try_again:
+	// When the time is up, the search ends as if there were no more candidates. (The first one, which doesn't share anything, has been already checked by then.)
+	if (TimeLimit::isUp())
+		return false;
 	// Don't let the familiar sight of the loop make an impression that control flow of this function is in any way understandable without analyzing specific paths.
 	for (std::size_t i = 0; i != subsetSelections.size(); ++i)
 	{
@@ -121,6 +194,126 @@ void SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::removeRedundantNodes(subsetS
 	}
 }
 
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::gateCount_t SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const
+{
+	gateCount_t gates = 0;
+	for (std::size_t i = 0; i != graph.size(); ++i)
+		if (usageCounts[i] != 0)
+			gates += countGates(i, subsetSelections[i]);
+	return gates;
+}
+
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+std::pair<typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::subsetSelections_t, typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::usageCounts_t> SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::findGreedySubsets(const std::vector<possibleSubsets_t> &candidateSubsets, Progress &progress) const
+{
+	// In each round, the subset that saves the most gates is given to all the sets that it makes cheaper. (A subset that isn't used yet has to pay for itself.)
+	// It stops when no subset saves anything, so it needs only a polynomial time but it may miss sharing that pays off only after a few steps.
+	subsetSelections_t subsetSelections(graph.size());
+	usageCounts_t usageCounts(graph.size());
+	for (const std::size_t endNode : endNodes)
+		usageCounts[endNode] = SIZE_MAX - graph.size();
+	std::vector<gateCount_t> gateCounts(graph.size());
+	std::vector<std::vector<std::size_t>> supersets(graph.size());
+	for (std::size_t i = 0; i != graph.size(); ++i)
+	{
+		gateCounts[i] = countGates(i, subsetSelections[i]);
+		for (const std::size_t subset : candidateSubsets[i])
+			supersets[subset].push_back(i);
+	}
+	
+	subsetSelection_t candidateSubsetSelection;
+	const auto calcGain = [this, &subsetSelections, &usageCounts, &gateCounts, &candidateSubsetSelection](const std::size_t superset, const std::size_t subset) -> gateCount_t {
+			const subsetSelection_t &subsetSelection = subsetSelections[superset];
+			if (usageCounts[superset] == 0 || std::find(subsetSelection.cbegin(), subsetSelection.cend(), subset) != subsetSelection.cend())
+				return 0;
+			candidateSubsetSelection = subsetSelection;
+			candidateSubsetSelection.push_back(subset);
+			const gateCount_t gates = countGates(superset, candidateSubsetSelection);
+			return gates < gateCounts[superset] ? gateCounts[superset] - gates : 0;
+		};
+	while (!TimeLimit::isUp())
+	{
+		progress.substep([](){ return 0.0; });
+		std::size_t bestSubset = SIZE_MAX;
+		gateCount_t bestSavedGates = 0;
+		for (std::size_t subset = 0; subset != graph.size(); ++subset)
+		{
+			gateCount_t savedGates = 0;
+			for (const std::size_t superset : supersets[subset])
+				savedGates += calcGain(superset, subset);
+			const gateCount_t ownGates = usageCounts[subset] == 0 ? gateCounts[subset] : 0;
+			if (savedGates > ownGates && savedGates - ownGates > bestSavedGates)
+			{
+				bestSubset = subset;
+				bestSavedGates = savedGates - ownGates;
+			}
+		}
+		if (bestSubset == SIZE_MAX)
+			break;
+		
+		for (const std::size_t superset : supersets[bestSubset])
+		{
+			const gateCount_t gain = calcGain(superset, bestSubset);
+			if (gain == 0)
+				continue;
+			subsetSelections[superset].push_back(bestSubset);
+			gateCounts[superset] -= gain;
+			++usageCounts[bestSubset];
+		}
+	}
+	
+	// A subset chosen early may be made useless by the ones chosen later. The supersets are visited first, so a subset that stops being used releases its own subsets before they are visited.
+	for (std::size_t i = graph.size(); i --> 0;)
+	{
+		subsetSelection_t &subsetSelection = subsetSelections[i];
+		for (std::size_t j = subsetSelection.size(); j --> 0;)
+		{
+			if (usageCounts[i] != 0)
+			{
+				candidateSubsetSelection = subsetSelection;
+				candidateSubsetSelection.erase(candidateSubsetSelection.begin() + j);
+				if (countGates(i, candidateSubsetSelection) > gateCounts[i])
+					continue;
+				gateCounts[i] = countGates(i, candidateSubsetSelection);
+			}
+			--usageCounts[subsetSelection[j]];
+			subsetSelection.erase(subsetSelection.begin() + j);
+		}
+	}
+	
+	removeRedundantNodes(subsetSelections, usageCounts);
+	for (subsetSelection_t &subsetSelection : subsetSelections)
+		std::sort(subsetSelection.begin(), subsetSelection.end());
+	return {subsetSelections, usageCounts};
+}
+
+template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
+std::pair<typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::subsetSelections_t, typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::usageCounts_t> SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::findGreedySubsets(Progress &progress) const
+{
+	// Choosing only from the direct subsets builds chains of sets that are contained in each other but it can't share a part common to a few sets through an intermediate set that doesn't pay off on its own.
+	// Choosing from all the subsets is the other way around, so both are tried.
+	std::vector<possibleSubsets_t> directSubsets(graph.size()), allSubsets(graph.size());
+	for (std::size_t i = 0; i != graph.size(); ++i)
+	{
+		directSubsets[i] = graph[i].second;
+		possibleSubsets_t &subsets = allSubsets[i];
+		for (const std::size_t subset : graph[i].second)
+		{
+			subsets.push_back(subset);
+			subsets.insert(subsets.end(), allSubsets[subset].cbegin(), allSubsets[subset].cend());
+		}
+		std::sort(subsets.begin(), subsets.end());
+		subsets.erase(std::unique(subsets.begin(), subsets.end()), subsets.end());
+	}
+	
+	auto chainedSubsets = findGreedySubsets(directSubsets, progress);
+	auto sharedSubsets = findGreedySubsets(allSubsets, progress);
+	if (countGates(sharedSubsets.first, sharedSubsets.second) < countGates(chainedSubsets.first, chainedSubsets.second))
+		return sharedSubsets;
+	return chainedSubsets;
+}
+
 template<typename SET, typename VALUE_ID, template<typename> class FINDER_CONTAINER>
 std::pair<typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::subsetSelections_t, typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::usageCounts_t> SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::findBestSubsets(Progress &progress) const
 {
@@ -129,6 +322,12 @@ std::pair<typename SetOptimizer<SET, VALUE_ID, FINDER_CONTAINER>::subsetSelectio
 	for (const std::size_t endNode : endNodes)
 		usageCounts[endNode] = SIZE_MAX - graph.size();
 	std::size_t bestGates = SIZE_MAX;
+	// The greedy result can be a starting point that is kept if the search finds nothing better (e.g. when the time limit stops it).
+	if (options::cseMethod.getValue() == options::CseMethod::SEEDED)
+	{
+		std::tie(bestSubsetSelections, bestUsageCounts) = findGreedySubsets(progress);
+		bestGates = countGates(bestSubsetSelections, bestUsageCounts);
+	}
 	const auto estimateCompletion = [this, &subsetSelections = std::as_const(subsetSelections), &usageCounts = std::as_const(usageCounts)](){ return SetOptimizer::estimateCompletion(subsetSelections, usageCounts); };
 	while (true)
 	{
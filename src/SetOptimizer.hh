@@ -1,6 +1,10 @@
 #pragma once
 
 #include <cstddef>
+#include <deque>
+#include <map>
+#include <mutex>
+#include <optional>
 #include <set>
 #include <utility>
 #include <vector>
@@ -36,15 +40,34 @@ public:
 		finalSets_t finalSets;
 		subsetSelections_t subsets;
 	};
+	// Results of earlier optimizations, keyed by the sorted list of the distinct sets they were made from. It is safe to use from many threads at once.
+	class Cache
+	{
+		using results_t = std::map<sets_t, Result>;
+		
+		const std::size_t maxSize;
+		std::mutex mutex;
+		results_t results;
+		std::deque<typename results_t::const_iterator> insertionOrder;
+		std::size_t lookupCount = 0, hitCount = 0;
+	
+	public:
+		explicit Cache(const std::size_t maxSize) : maxSize(maxSize) {}
+		
+		[[nodiscard]] std::optional<Result> find(const sets_t &sets);
+		void insert(const sets_t &sets, const Result &result);  // When the cache is full, the oldest result is dropped.
+		void printStatistics(const char name[]);
+	};
 	
 protected:
 	SetOptimizer() = default;
 	
 	Result extractCommonParts(const sets_t &sets, Progress &progress);
+	Result extractCommonParts(const sets_t &sets, Progress &progress, Cache *const cache);
 	
 	virtual typename SubsetFinder::sets_t convertSets(const sets_t &sets) const = 0;
 	virtual void makeGraph(const typename SubsetFinder::setHierarchy_t &setHierarchy) = 0;
-	virtual gateCount_t countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const = 0;
+	virtual gateCount_t countGates(const std::size_t node, const subsetSelection_t &subsetSelection) const = 0;
 	virtual void substractSubsets(sets_t &sets, const subsetSelections_t &subsetSelections) = 0;
 	
 private:
@@ -52,6 +75,9 @@ private:
 	Progress::completion_t estimateCompletion(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const;
 	bool chooseNextSubsets(subsetSelections_t &subsetSelections, usageCounts_t &usageCounts) const;
 	void removeRedundantNodes(subsetSelections_t &subsetSelections, usageCounts_t &usageCounts) const;
+	gateCount_t countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const;
+	std::pair<subsetSelections_t, usageCounts_t> findGreedySubsets(const std::vector<possibleSubsets_t> &candidateSubsets, Progress &progress) const;
+	std::pair<subsetSelections_t, usageCounts_t> findGreedySubsets(Progress &progress) const;
 	std::pair<subsetSelections_t, usageCounts_t> findBestSubsets(Progress &progress) const;
 	void removeUnusedSubsets(subsetSelections_t &subsetSelections, usageCounts_t &usageCounts);
 	sets_t makeSets() const;
@@ -60,21 +60,15 @@ void SetOptimizerForProducts::makeGraph(const SubsetFinder::setHierarchy_t &setH
 	}
 }
 
-SetOptimizerForProducts::gateCount_t SetOptimizerForProducts::countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const
+SetOptimizerForProducts::gateCount_t SetOptimizerForProducts::countGates(const std::size_t node, const subsetSelection_t &subsetSelection) const
 {
-	gateCount_t gates = 0;
-	for (std::size_t i = 0; i != graph.size(); ++i)
-	{
-		if (usageCounts[i] == 0)
-			continue;
-		gates += subsetSelections[i].size();
-		Implicant reducedProduct = graph[i].first;
-		for (const std::size_t &subset : subsetSelections[i])
-			reducedProduct -= graph[subset].first;
-		gates += reducedProduct.getBitCount();
-		if (subsetSelections[i].size() != 0 || reducedProduct.getBitCount() != 0)
-			--gates;
-	}
+	gateCount_t gates = subsetSelection.size();
+	Implicant reducedProduct = graph[node].first;
+	for (const std::size_t &subset : subsetSelection)
+		reducedProduct -= graph[subset].first;
+	gates += reducedProduct.getBitCount();
+	if (subsetSelection.size() != 0 || reducedProduct.getBitCount() != 0)
+		--gates;
 	return gates;
 }
 
@@ -11,11 +11,11 @@
 class SetOptimizerForProducts : public SetOptimizer<Implicant, std::int_fast8_t, std::vector>
 {
 public:
-	static Result optimizeSet(const sets_t &sets, Progress &progress) { const auto infoGuard = progress.addInfo("Products"); return SetOptimizerForProducts().extractCommonParts(sets, progress); }
+	static Result optimizeSet(const sets_t &sets, Progress &progress, Cache *const cache = nullptr) { const auto infoGuard = progress.addInfo("Products"); return SetOptimizerForProducts().extractCommonParts(sets, progress, cache); }
 	
 protected:
 	SubsetFinder::sets_t convertSets(const sets_t &sets) const final;
 	void makeGraph(const SubsetFinder::setHierarchy_t &setHierarchy) final;
-	gateCount_t countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const final;
+	gateCount_t countGates(const std::size_t node, const subsetSelection_t &subsetSelection) const final;
 	void substractSubsets(sets_t &sets, const subsetSelections_t &subsetSelections) final;
 };
@@ -26,25 +26,19 @@ void SetOptimizerForSums::makeGraph(const SubsetFinder::setHierarchy_t &setHiera
 	}
 }
 
-SetOptimizerForSums::gateCount_t SetOptimizerForSums::countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const
+SetOptimizerForSums::gateCount_t SetOptimizerForSums::countGates(const std::size_t node, const subsetSelection_t &subsetSelection) const
 {
-	gateCount_t gates = 0;
-	for (std::size_t i = 0; i != graph.size(); ++i)
+	gateCount_t gates = subsetSelection.size();
+	std::set<std::size_t> reducedSet = graph[node].first;
+	for (const std::size_t &subset : subsetSelection)
 	{
-		if (usageCounts[i] == 0)
-			continue;
-		gates += subsetSelections[i].size();
-		std::set<std::size_t> reducedSet = graph[i].first;
-		for (const std::size_t &subset : subsetSelections[i])
-		{
-			std::set<std::size_t> setDifference;
-			std::set_difference(reducedSet.cbegin(), reducedSet.cend(), graph[subset].first.cbegin(), graph[subset].first.cend(), std::inserter(setDifference, setDifference.end()));
-			reducedSet = std::move(setDifference);
-		}
-		gates += reducedSet.size();
-		if (subsetSelections[i].size() != 0 || !reducedSet.empty())
-			--gates;
+		std::set<std::size_t> setDifference;
+		std::set_difference(reducedSet.cbegin(), reducedSet.cend(), graph[subset].first.cbegin(), graph[subset].first.cend(), std::inserter(setDifference, setDifference.end()));
+		reducedSet = std::move(setDifference);
 	}
+	gates += reducedSet.size();
+	if (subsetSelection.size() != 0 || !reducedSet.empty())
+		--gates;
 	return gates;
 }
 
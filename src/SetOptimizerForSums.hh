@@ -10,11 +10,11 @@
 class SetOptimizerForSums : public SetOptimizer<std::set<std::size_t>, std::size_t, std::set>
 {
 public:
-	static Result optimizeSet(const sets_t &sets, Progress &progress) { const auto infoGuard = progress.addInfo("Sums"); return SetOptimizerForSums().extractCommonParts(sets, progress); }
+	static Result optimizeSet(const sets_t &sets, Progress &progress, Cache *const cache = nullptr) { const auto infoGuard = progress.addInfo("Sums"); return SetOptimizerForSums().extractCommonParts(sets, progress, cache); }
 	
 protected:
 	SubsetFinder::sets_t convertSets(const sets_t &sets) const final;
 	void makeGraph(const SubsetFinder::setHierarchy_t &setHierarchy) final;
-	gateCount_t countGates(const subsetSelections_t &subsetSelections, const usageCounts_t &usageCounts) const final;
+	gateCount_t countGates(const std::size_t node, const subsetSelection_t &subsetSelection) const final;
 	void substractSubsets(sets_t &sets, const subsetSelections_t &subsetSelections) final;
 };
@@ -0,0 +1,19 @@
+#include "./TimeLimit.hh"
+
+#include <chrono>
+#include <thread>
+
+
+std::atomic<bool> TimeLimit::passed = false, TimeLimit::cutShort = false;
+
+void TimeLimit::start(const unsigned seconds)
+{
+	if (seconds == 0)
+		return;
+	// The thread is detached because it only sleeps and it doesn't own anything that would need to be cleaned up at the exit.
+	const std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::now() + std::chrono::seconds(seconds);
+	std::thread([deadline](){
+			std::this_thread::sleep_until(deadline);
+			passed.store(true, std::memory_order_relaxed);
+		}).detach();
+}
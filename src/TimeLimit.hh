@@ -0,0 +1,19 @@
+#pragma once
+
+#include <atomic>
+
+
+// The wall-clock limit of the whole run set by `--time-limit`.
+// Long stages check it cooperatively. When it has passed, they stop and continue with the best valid result they have so far.
+// A separate thread raises the flag when the time is up, so checking it is only an atomic load and it can be done even in hot loops.
+class TimeLimit
+{
+	static std::atomic<bool> passed, cutShort;
+	
+public:
+	static void start(const unsigned seconds);  // Zero means no limit.
+	
+	// Tells whether the calling stage should stop. If it says so, the final result is reported as possibly not optimal.
+	[[nodiscard]] static bool isUp() { if (!passed.load(std::memory_order_relaxed)) return false; cutShort.store(true, std::memory_order_relaxed); return true; }
+	[[nodiscard]] static bool wasAnythingCutShort() { return cutShort.load(std::memory_order_relaxed); }
+};
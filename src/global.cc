@@ -4,7 +4,7 @@
 bool terminalStdin, terminalInput, terminalStderr;
 
 std::optional<std::string_view> inputFilePath;
-Names inputNames;
 
-bits_t bits;
-std::uint_fast32_t maxMinterm;
+thread_local Names inputNames;
+thread_local bits_t bits;
+thread_local std::uint_fast32_t maxMinterm;
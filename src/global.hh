@@ -11,9 +11,21 @@
 extern bool terminalStdin, terminalInput, terminalStderr;
 
 extern std::optional<std::string_view> inputFilePath;
-extern Names inputNames;
 
+// The description of inputs is thread-local because in batch mode multiple problems can be solved at once.
+extern thread_local Names inputNames;
 using bits_t = std::uint_fast8_t;
 constexpr bits_t maxBits = 32;
-extern bits_t bits;
-extern std::uint_fast32_t maxMinterm;
+extern thread_local bits_t bits;
+extern thread_local std::uint_fast32_t maxMinterm;
+
+// A copy of the thread-local state above, used to pass it to other threads.
+struct InputsState
+{
+	Names inputNames;
+	bits_t bits;
+	std::uint_fast32_t maxMinterm;
+	
+	[[nodiscard]] static InputsState save() { return {::inputNames.copy(), ::bits, ::maxMinterm}; }
+	void restore() const { ::inputNames = inputNames.copy(); ::bits = bits; ::maxMinterm = maxMinterm; }
+};
@@ -27,11 +27,27 @@ void printShortHelp()
 			"    -s, --status[=X]\t- Set whether things like the current operation,\n\t\t\t  progress bar, ET, ETA and so on are shown.\n\t\t\t  Valid values are \"always\", \"never\" and \"default\".\n\t\t\t  (No value means \"always\".) By default, they are shown\n\t\t\t  only when the stderr is a TTY.\n"
 			"    -S, --no-status\t- Same as `--status=never`.\n"
 			" output:\n"
-			"    -f, --format=X\t- Set the output format. (See \"Output formats\".)\n\t\t\t  (Mathematical formats imply `--no-optimize`.)\n"
+			"    -f, --format=X\t- Set the output format. (See \"Output formats\".)\n\t\t\t  (Mathematical formats and PLA imply `--no-optimize`.)\n"
 			"    -n, --name=X\t- Set module name for Verilog output or entity name for\n\t\t\t  VHDL output or class name for C++ output.\n\t\t\t  (By default, the name of the input file is used,\n\t\t\t  or \"Karnaugh\" if input is read from stdin.)\n"
 			"    -G, --verbose-graph\t- Show shows all inputs in every node of a graph output,\n\t\t\t  instead only the ones added by that node. (It's more\n\t\t\t  readable but less useful for building the circuit.)\n"
+			"    -B, --to-binary\t- Convert the input to the binary format and print it\n\t\t\t  instead of solving it. (See \"Input\".)\n"
+			" performance:\n"
+			"    -j, --jobs=N\t- Set the maximum number of threads to use.\n\t\t\t  (By default, it is the number of hardware threads.)\n"
+			"    -b, --batch\t\t- Solve many independent problems separated by lines\n\t\t\t  \"===\" in a single run. Their outputs are separated\n\t\t\t  the same way. (With multiple jobs, the problems are\n\t\t\t  solved concurrently and progress is not shown.)\n"
+			"    -V, --statistics\t- Print the sizes of intermediate results of Petrick's\n\t\t\t  method and the number of combinations of solutions\n\t\t\t  pruned while eliminating common subexpressions to\n\t\t\t  stderr.\n"
+			"    -t, --time-limit=N\t- Stop solving N seconds after the start of the run and\n\t\t\t  print the best valid solution found so far. A warning\n\t\t\t  on stderr says that it may not be optimal. (In batch\n\t\t\t  mode, the limit is shared by all problems. By default,\n\t\t\t  it is 0, which means no limit.)\n"
+			" 2nd stage - solving:\n"
+			"    -m, --merge=X\t- Set the algorithm used to merge implicants while\n\t\t\t  looking for prime implicants. (See \"Merge methods\".)\n"
+			"    -c, --cover=X\t- Set the algorithm used to choose prime implicants that\n\t\t\t  cover the function. (See \"Cover methods\".)\n"
+			"    -k, --cost-slack=N\t- Make `--cover=branch-and-bound` return also solutions\n\t\t\t  that cost up to N more than the cheapest one. They\n\t\t\t  give more options for the 3rd stage. (By default, 0.)\n"
+			"    -e, --product-store=X - Set how Petrick's method stores the products while\n\t\t\t  expanding them. (See \"Product stores\".)\n"
+			"    -r, --reduce[=X]\t- Set whether the covering problem is reduced to its\n\t\t\t  cyclic core before solving it. (Secondary essentials\n\t\t\t  are extracted and dominated prime implicants are\n\t\t\t  removed.) Valid values are \"always\", \"never\" and\n\t\t\t  \"default\". (No value means \"always\".) By default, it is\n\t\t\t  done only when just the cheapest covers are needed.\n"
+			"    -R, --no-reduce\t- Same as `--reduce=never`.\n"
 			" 3rd stage - common subexpression elimination:\n"
 			"    -O, --no-optimize\t- Skip the common subexpression elimination optimization\n\t\t\t  and show only a raw solution for each function.\n"
+			"    -M, --cse-margin=N\t- Before the elimination, drop the solutions of each\n\t\t\t  function whose gate score is more than N above\n\t\t\t  the cheapest one. (It makes the search faster but it\n\t\t\t  may miss a better sharing. By default, there is no\n\t\t\t  margin.)\n"
+			"    -C, --cse-cache=N\t- Set how many results of common parts of products and\n\t\t\t  of sums are remembered for reuse by other combinations\n\t\t\t  of solutions. (Their hit rates are printed with\n\t\t\t  `--statistics`. 0 turns the caches off. By default,\n\t\t\t  it is 4096.)\n"
+			"    -E, --cse-method=X\t- Set how the common parts are chosen. (See \"CSE\n\t\t\t  methods\".)\n"
 		;
 }
 
@@ -55,6 +71,28 @@ void printHelp()
 			"\tmath-prog\t- A mathematical notation with programming operators.\n"
 			"\tmath-names\t- A mathematical notation that uses names of operators.\n"
 			"\tgate-costs\t- Only gate costs. (Useful mostly for development.)\n"
+			"\tpla\t\t- A Berkeley PLA file (the format used by Espresso).\n"
+			"\n"
+			"\n"
+			"Merge methods:\n"
+			"\thash-table\t- The default method which, for each implicant, looks up\n\t\t\t  all its possible merge partners in a hash table.\n"
+			"\tbuckets\t\t- Implicants are grouped by their masks and numbers of\n\t\t\t  true bits and every pair from neighboring groups is\n\t\t\t  compared. (Useful mostly for benchmarking.)\n"
+			"\n"
+			"\n"
+			"Cover methods:\n"
+			"\tpetrick\t\t- The default method which creates every irredundant\n\t\t\t  cover using Petrick's method. (Its memory usage is\n\t\t\t  exponential.)\n"
+			"\tbranch-and-bound - A depth-first search which skips branches that cannot\n\t\t\t  be cheaper than the best cover found so far. It finds\n\t\t\t  only the cheapest covers (and those within the slack).\n"
+			"\n"
+			"Product stores:\n"
+			"\tauto\t\t- The default which chooses bitsets when there are at most\n\t\t\t  1024 prime implicants left and the Hasse diagram\n\t\t\t  otherwise.\n"
+			"\thasse-diagram\t- A trie of sorted lists of prime implicants which removes\n\t\t\t  supersets as they are inserted.\n"
+			"\tbitsets\t\t- Flat arrays of bitsets where unions and subset tests\n\t\t\t  are a few word-wise operations. Supersets are removed\n\t\t\t  in batches.\n"
+			"Both stores give the same solutions in the same (lexicographic) order.\n"
+			"\n"
+			"CSE methods:\n"
+			"\texhaustive\t- The default method which checks every choice of common\n\t\t\t  parts and finds the one with the fewest gates. (Its\n\t\t\t  time is exponential.)\n"
+			"\tgreedy\t\t- Repeatedly shares the common part that saves the most\n\t\t\t  gates until none saves anything. It is fast even for\n\t\t\t  many functions but the result may not be optimal.\n"
+			"\tseeded\t\t- The exhaustive method which starts from the result of\n\t\t\t  the greedy one. (Useful with `--time-limit`.)\n"
 			"\n"
 			"\n"
 			"Input:\n"
@@ -63,9 +101,12 @@ void printHelp()
 			"- The description of inputs is either a list of their names or just their count.\n"
 			"- The functions are separated by line breaks and are defined like this:\n  [NAME <line-break>] LIST_OF_MINTERMS <line-break> LIST_OF_DONT_CARES\n"
 			"- Input names, minterms and don't-cares are lists of numbers separated by\n  whitespaces and/or and punctuation characters except \"-\", \"_\" and \"#\".\n  (A single dash may be used to indicate an empty list.)\n"
+			"- Minterms and don't-cares can also be given as ranges (e.g. \"16..31\") or as\n  cubes which have one character for each input: \"0\", \"1\" or \"-\" for both\n  (e.g. \"1-0-\" for 4 inputs).\n"
 			"- Lines with any letters in them are considered to contain names.\n"
 			"- Leading and trailing whitespaces are stripped as well as everything after the\n  \"#\" character (comments).\n"
 			"- Blank lines and comment-only lines are ignored.\n"
+			"- Alternatively, the input can be a Berkeley PLA file (types \"f\" and \"fd\").\n"
+			"- The input can also be in a binary format with packed truth tables, which is\n  much faster to load for large functions. It is produced by `--to-binary`.\n"
 			"\n"
 			"An example of an input:\n"
 			"\n"
@@ -1,9 +1,18 @@
+#include <algorithm>
+#include <atomic>
+#include <charconv>
 #include <fstream>
 #include <iostream>
 #include <istream>
+#include <iterator>
 #include <memory>
+#include <optional>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <vector>
 
+#include "BinaryReader.hh"
 #include "global.hh"
 #include "info.hh"
 #include "Input.hh"
@@ -11,14 +20,18 @@
 #include "non-stdlib-stuff.hh"
 #include "options.hh"
 #include "Progress.hh"
+#include "TimeLimit.hh"
+#include "utils.hh"
 
 
+static void setInputBits(const bits_t bits)
+{
+	::bits = bits;
+	::maxMinterm = ::bits == 0 ? 0 : ((Minterm(1) << (::bits - 1)) - 1) * 2 + 1;
+}
+
 static bool parseInputBits(Input &input)
 {
-	if (options::prompt.getValue())
-		std::cerr << "Enter a list of input variables or their count:\n";
-	if (input.hasError())
-		return false;
 	if (input.isEmpty())
 	{
 		std::cerr << "The description of inputs is missing!\n";
@@ -34,15 +47,15 @@ static bool parseInputBits(Input &input)
 			Progress::cerr() << "Too many input variables!\n";
 			return false;
 		}
-		::bits = static_cast<::bits_t>(names.size());
+		setInputBits(static_cast<::bits_t>(names.size()));
 		::inputNames = Names(true, std::move(names), "i");
 	}
 	else
 	{
-		const std::string line = input.popLine();
+		const std::string line(input.popLine());
 		if (line == "-")
 		{
-			::bits = 0;
+			setInputBits(0);
 			::inputNames = Names(true, {}, "i");
 			return true;
 		}
@@ -59,7 +72,7 @@ static bool parseInputBits(Input &input)
 				std::cerr << "Too many input variables!\n";
 				return false;
 			}
-			::bits = static_cast<::bits_t>(n);
+			setInputBits(static_cast<::bits_t>(n));
 		}
 		catch (std::invalid_argument &)
 		{
@@ -77,10 +90,159 @@ static bool parseInputBits(Input &input)
 			names.push_back("i" + std::to_string(i));
 		::inputNames = Names(false, std::move(names), "i");
 	}
-	::maxMinterm = ::bits == 0 ? 0 : ((Minterm(1) << (::bits - 1)) - 1) * 2 + 1;
 	return true;
 }
 
+static std::vector<std::string_view> splitWords(std::string_view line)
+{
+	std::vector<std::string_view> words;
+	while (true)
+	{
+		const std::string_view::size_type start = line.find_first_not_of(" \t\v\f\r");
+		if (start == std::string_view::npos)
+			break;
+		line.remove_prefix(start);
+		const std::string_view::size_type end = std::min(line.find_first_of(" \t\v\f\r"), line.size());
+		words.push_back(line.substr(0, end));
+		line.remove_prefix(end);
+	}
+	return words;
+}
+
+static bool parsePlaNumber(const std::string_view directive, const std::vector<std::string_view> &words, std::size_t &number)
+{
+	if (words.size() != 2)
+	{
+		std::cerr << "The PLA directive \"" << directive << "\" requires a single number!\n";
+		return false;
+	}
+	const auto [end, error] = std::from_chars(words[1].data(), words[1].data() + words[1].size(), number);
+	if (error == std::errc::result_out_of_range)
+	{
+		std::cerr << '"' << words[1] << "\" is out of range!\n";
+		return false;
+	}
+	if (error != std::errc() || end != words[1].data() + words[1].size())
+	{
+		std::cerr << "The PLA directive \"" << directive << "\" requires a single number!\n";
+		return false;
+	}
+	return true;
+}
+
+// The functions are allocated before their terms are read, so a malformed count has to be rejected first.
+static constexpr std::size_t maxPlaOutputs = 65536;
+
+static bool loadPla(Input &input, Karnaughs &karnaughs)
+{
+	std::optional<std::size_t> inputCount, outputCount;
+	Names::names_t inputNames, outputNames;
+	bool dontCaresInOutputs = true;
+	while (input.isDirective())
+	{
+		const std::vector<std::string_view> words = splitWords(input.popLine());
+		const std::string_view directive = words.front();
+		std::size_t number;
+		if (directive == ".i")
+		{
+			if (!parsePlaNumber(directive, words, number))
+				return false;
+			if (number > ::maxBits)
+			{
+				std::cerr << "Too many input variables!\n";
+				return false;
+			}
+			inputCount = number;
+		}
+		else if (directive == ".o")
+		{
+			if (!parsePlaNumber(directive, words, number))
+				return false;
+			if (number > maxPlaOutputs)
+			{
+				std::cerr << "Too many output functions!\n";
+				return false;
+			}
+			outputCount = number;
+		}
+		else if (directive == ".ilb")
+		{
+			inputNames.assign(std::next(words.cbegin()), words.cend());
+		}
+		else if (directive == ".ob")
+		{
+			outputNames.assign(std::next(words.cbegin()), words.cend());
+		}
+		else if (directive == ".p")
+		{
+			if (!parsePlaNumber(directive, words, number))  // The number of terms is not needed for anything.
+				return false;
+		}
+		else if (directive == ".type")
+		{
+			if (words.size() != 2 || (words[1] != "f" && words[1] != "fd"))
+			{
+				std::cerr << "Only the PLA types \"f\" and \"fd\" are supported!\n";
+				return false;
+			}
+			dontCaresInOutputs = words[1] == "fd";
+		}
+		else if (directive == ".e" || directive == ".end")
+		{
+			break;
+		}
+		else
+		{
+			std::cerr << "Unsupported PLA directive \"" << directive << "\"!\n";
+			return false;
+		}
+		if (input.hasError())
+			return false;
+	}
+	if (!inputCount || !outputCount)
+	{
+		std::cerr << "A PLA file has to contain the directives \".i\" and \".o\"!\n";
+		return false;
+	}
+	if ((!inputNames.empty() && inputNames.size() != *inputCount) || (!outputNames.empty() && outputNames.size() != *outputCount))
+	{
+		std::cerr << "The numbers of names in \".ilb\" and \".ob\" have to match \".i\" and \".o\"!\n";
+		return false;
+	}
+	
+	setInputBits(static_cast<bits_t>(*inputCount));
+	if (inputNames.empty())
+	{
+		for (bits_t i = 0; i != ::bits; ++i)
+			inputNames.push_back("i" + std::to_string(i));
+		::inputNames = Names(false, std::move(inputNames), "i");
+	}
+	else
+	{
+		::inputNames = Names(true, std::move(inputNames), "i");
+	}
+	return karnaughs.loadPlaData(input, *outputCount, std::move(outputNames), dontCaresInOutputs);
+}
+
+static bool loadBinary(const std::string_view contents, Karnaughs &karnaughs)
+{
+	BinaryReader reader(contents);
+	const std::uint8_t inputCount = reader.readByte();
+	const std::uint8_t hasInputNames = reader.readByte();
+	if (inputCount > ::maxBits || hasInputNames > 1)
+	{
+		std::cerr << "The binary input is malformed!\n";
+		return false;
+	}
+	setInputBits(inputCount);
+	Names::names_t inputNames;
+	inputNames.reserve(::bits);
+	for (bits_t i = 0; i != ::bits; ++i)
+		inputNames.push_back(hasInputNames != 0 ? std::string(reader.readString()) : "i" + std::to_string(i));
+	::inputNames = Names(hasInputNames != 0, std::move(inputNames), "i");
+	return karnaughs.loadBinaryData(reader);
+}
+
 static void deleteIstream(const std::istream *const stream) {
 	if (stream != &std::cin)
 		delete stream;
@@ -118,9 +280,26 @@ static IstreamUniquePtr prepareIstream()
 	}
 }
 
-static bool loadInput(IstreamUniquePtr istream, Karnaughs &karnaughs)
+static std::unique_ptr<MappedFile> mapInputFile()
 {
-	Input input(*istream);
+	if (options::freeArgs.size() != 1 || options::freeArgs.front() == "-")
+		return nullptr;
+	const std::string path(options::freeArgs.front());
+	std::unique_ptr<MappedFile> mappedFile = std::make_unique<MappedFile>(path.c_str());
+	if (!mappedFile->isMapped())
+		return nullptr;  // The stream will be used instead. (It also takes care of reporting errors.)
+	::inputFilePath = options::freeArgs.front();
+	return mappedFile;
+}
+
+static bool loadInput(Input &input, Karnaughs &karnaughs)
+{
+	if (options::prompt.getValue())
+		std::cerr << "Enter a list of input variables or their count:\n";
+	if (input.hasError())
+		return false;
+	if (input.isDirective())
+		return loadPla(input, karnaughs);
 	if (!parseInputBits(input))
 		return false;
 	if (!karnaughs.loadData(input))
@@ -128,23 +307,143 @@ static bool loadInput(IstreamUniquePtr istream, Karnaughs &karnaughs)
 	return true;
 }
 
-static bool processInput(IstreamUniquePtr istream)
+static void solveKarnaughs(Karnaughs &karnaughs)
+{
+	if (!options::toBinary.isRaised())
+		karnaughs.solve();
+}
+
+static void printKarnaughs(Karnaughs &karnaughs)
+{
+	if (options::toBinary.isRaised())
+		karnaughs.printBinary();
+	else
+		karnaughs.print();
+}
+
+static void processKarnaughs(Karnaughs &karnaughs)
+{
+	solveKarnaughs(karnaughs);
+	printKarnaughs(karnaughs);
+}
+
+static bool processInput(Input &input)
+{
+	Karnaughs karnaughs;
+	if (!loadInput(input, karnaughs))
+		return false;
+	processKarnaughs(karnaughs);
+	return true;
+}
+
+static bool processBinaryInput(const std::string_view contents)
 {
 	Karnaughs karnaughs;
-	if (!loadInput(std::move(istream), karnaughs))
+	if (!loadBinary(contents, karnaughs))
 		return false;
-	karnaughs.solve();
-	karnaughs.print();
+	processKarnaughs(karnaughs);
 	return true;
 }
 
+static std::vector<std::string_view> splitBatch(const std::string_view contents)
+{
+	// Problems are separated by lines that contain only "===" (and optionally whitespaces and a comment).
+	std::vector<std::string_view> problems;
+	std::string_view::size_type problemStart = 0, lineStart = 0;
+	while (lineStart != contents.size())
+	{
+		const std::string_view::size_type lineEnd = std::min(contents.find('\n', lineStart), contents.size());
+		std::string_view line = contents.substr(lineStart, lineEnd - lineStart);
+		line = line.substr(0, line.find('#'));
+		const std::string_view::size_type first = line.find_first_not_of(" \t\v\f\r");
+		if (first != std::string_view::npos && line.substr(first, line.find_last_not_of(" \t\v\f\r") + 1 - first) == "===")
+		{
+			problems.push_back(contents.substr(problemStart, lineStart - problemStart));
+			problemStart = std::min(lineEnd + 1, contents.size());
+		}
+		lineStart = std::min(lineEnd + 1, contents.size());
+	}
+	problems.push_back(contents.substr(problemStart));
+	return problems;
+}
+
+static bool loadProblem(const std::string_view problem, Karnaughs &karnaughs)
+{
+	Karnaugh::resetNameCount();
+	Progress::resetStages();
+	if (BinaryReader::isBinary(problem))
+		return loadBinary(problem, karnaughs);
+	Input input(problem);
+	return loadInput(input, karnaughs);
+}
+
+static bool processBatch(const std::string_view contents)
+{
+	options::prompt.setValue(false);
+	const std::vector<std::string_view> problems = splitBatch(contents);
+	const std::size_t threadCount = std::min<std::size_t>(options::jobs.getValue(), problems.size());
+	bool success = true;
+	if (threadCount <= 1)
+	{
+		for (std::size_t i = 0; i != problems.size(); ++i)
+		{
+			if (i != 0)
+				std::cout << "===\n";
+			Karnaughs karnaughs;
+			if (loadProblem(problems[i], karnaughs))
+				processKarnaughs(karnaughs);
+			else
+				success = false;
+		}
+		return success;
+	}
+	
+	// Problems are solved concurrently but printed in order when all of them are done.
+	options::status.setValue(false);  // Progress of multiple problems would be mixed together.
+	options::jobs.setValue(1);  // The threads are already used by the problems, so each one of them is solved by a single thread.
+	std::vector<Karnaughs> karnaughses(problems.size());
+	std::vector<InputsState> inputsStates(problems.size());
+	std::vector<char> loaded(problems.size(), false);  // Not `std::vector<bool>` because its elements are written from multiple threads.
+	std::atomic<std::size_t> nextProblem = 0;
+	runInParallel(threadCount, [&problems, &karnaughses, &inputsStates, &loaded, &nextProblem](const std::size_t){
+			for (std::size_t i = nextProblem++; i < problems.size(); i = nextProblem++)
+			{
+				loaded[i] = loadProblem(problems[i], karnaughses[i]);
+				if (loaded[i])
+					solveKarnaughs(karnaughses[i]);
+				inputsStates[i] = InputsState::save();
+			}
+		});
+	for (std::size_t i = 0; i != problems.size(); ++i)
+	{
+		if (i != 0)
+			std::cout << "===\n";
+		if (!loaded[i])
+		{
+			success = false;
+			continue;
+		}
+		inputsStates[i].restore();
+		printKarnaughs(karnaughses[i]);
+	}
+	return success;
+}
+
+// A result that was cut short by the time limit is still a valid one, so it is printed normally and only this warning tells about it.
+static int finish(const bool success)
+{
+	if (TimeLimit::wasAnythingCutShort())
+		std::cerr << "The time limit was reached, so the result may not be optimal!\n";
+	return success ? 0 : 1;
+}
+
 int main(const int argc, const char *const *const argv)
 {
 	Progress::init();
 	
 	if (!options::parse(argc, argv))
 		return 1;
-	if (options::outputFormat.getValue() == options::OutputFormat::MATH_FORMAL || options::outputFormat.getValue() == options::OutputFormat::MATH_PROG || options::outputFormat.getValue() == options::OutputFormat::MATH_ASCII || options::outputFormat.getValue() == options::OutputFormat::MATH_NAMES)
+	if (options::outputFormat.getValue() == options::OutputFormat::MATH_FORMAL || options::outputFormat.getValue() == options::OutputFormat::MATH_PROG || options::outputFormat.getValue() == options::OutputFormat::MATH_ASCII || options::outputFormat.getValue() == options::OutputFormat::MATH_NAMES || options::outputFormat.getValue() == options::OutputFormat::PLA)
 		options::skipOptimization.raise();
 	
 	if (options::helpOptions.isRaised())  // `--help-options` is before `--help` because it should be used when both flags are present.
@@ -165,16 +464,38 @@ int main(const int argc, const char *const *const argv)
 	
 	enableAnsiSequences();
 	
-	IstreamUniquePtr istream = prepareIstream();
-	if (!istream)
-		return 1;
+	const std::unique_ptr<MappedFile> mappedFile = mapInputFile();
+	IstreamUniquePtr istream(nullptr, deleteIstream);
+	if (!mappedFile)
+	{
+		istream = prepareIstream();
+		if (!istream)
+			return 1;
+	}
 	
 	::terminalStdin = isStdinTerminal();
 	::terminalInput = ::terminalStdin && istream.get() == &std::cin;
 	::terminalStderr = isStderrTerminal();
+	options::resolveDefaults();
+	TimeLimit::start(options::timeLimit.getValue());
 	
-	if (!processInput(std::move(istream)))
-		return 1;
+	// The binary format starts with a null character, so a stream is read at once only when it starts with one (or in batch mode). A terminal is not peeked at, since that would block before the prompt is shown.
+	std::string streamContents;
+	std::optional<std::string_view> contents;
+	if (mappedFile)
+	{
+		contents = mappedFile->getContents();
+	}
+	else if (options::batch.isRaised() || (!::terminalInput && istream->peek() == '\0'))
+	{
+		streamContents.assign(std::istreambuf_iterator<char>(*istream), std::istreambuf_iterator<char>());
+		contents = streamContents;
+	}
 	
-	return 0;
+	if (options::batch.isRaised())
+		return finish(processBatch(*contents));
+	if (contents && BinaryReader::isBinary(*contents))
+		return finish(processBinaryInput(*contents));
+	Input input = contents ? Input(*contents) : Input(*istream);
+	return finish(processInput(input));
 }
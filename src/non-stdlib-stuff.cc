@@ -6,6 +6,14 @@
 #include <Windows.h>
 #endif
 
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#define MAPPED_FILE_SUPPORTED
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
 
 #if defined(WIN32) || defined(_WIN32) || defined(__WIN32__) || defined(__NT__)
 static bool isTerminal(const DWORD stream)
@@ -42,3 +50,46 @@ void enableAnsiSequences()
 	enableAnsiSequences(STD_ERROR_HANDLE);
 }
 #endif
+
+
+#ifdef MAPPED_FILE_SUPPORTED
+MappedFile::MappedFile(const char path[])
+{
+	const int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return;
+	struct stat fileStat;
+	if (fstat(fd, &fileStat) == 0 && S_ISREG(fileStat.st_mode))
+	{
+		size = static_cast<std::size_t>(fileStat.st_size);
+		if (size == 0)
+		{
+			mapped = true;
+		}
+		else
+		{
+			void *const address = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+			if (address != MAP_FAILED)
+			{
+				posix_madvise(address, size, POSIX_MADV_SEQUENTIAL);
+				data = static_cast<const char*>(address);
+				mapped = true;
+			}
+			else
+			{
+				size = 0;
+			}
+		}
+	}
+	close(fd);
+}
+
+MappedFile::~MappedFile()
+{
+	if (data != nullptr)
+		munmap(const_cast<char*>(data), size);
+}
+#else
+MappedFile::MappedFile(const char []) {}  // Not supported - the file will be read through a stream.
+MappedFile::~MappedFile() {}
+#endif
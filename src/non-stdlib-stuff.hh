@@ -1,5 +1,8 @@
 #pragma once
 
+#include <cstddef>
+#include <string_view>
+
 #if __has_include(<unistd.h>)
 #include <unistd.h>
 #endif
@@ -33,3 +36,21 @@ void enableAnsiSequences();
 #else
 inline void enableAnsiSequences() {}
 #endif
+
+
+// A read-only memory mapping of a whole regular file. (When the file cannot be mapped, `isMapped` returns `false` and the caller should fall back to streams.)
+class MappedFile
+{
+	const char *data = nullptr;
+	std::size_t size = 0;
+	bool mapped = false;
+	
+public:
+	explicit MappedFile(const char path[]);
+	MappedFile(const MappedFile&) = delete;
+	MappedFile& operator=(const MappedFile&) = delete;
+	~MappedFile();
+	
+	[[nodiscard]] bool isMapped() const { return mapped; }
+	[[nodiscard]] std::string_view getContents() const { return {data, size}; }
+};
@@ -1,5 +1,9 @@
 #include "./options.hh"
 
+#include <algorithm>
+#include <limits>
+#include <thread>
+
 #include "global.hh"
 
 
@@ -35,20 +39,70 @@ namespace options
 			{"math-prog", "math(?:ematic(?:s|al)?)?[-_]prog(?:ram(?:ing)?)?|prog(?:ram(?:ming)?)?[-_]math(?:ematic(?:s|al)?)?|m[-_]?p|p[-_]?m", OutputFormat::MATH_PROG},
 			{"math-names", "math(?:ematic(?:s|al)?)?[-_](?:names?|words?|text)|(?:names?|words?|text)[-_]math(?:ematic(?:s|al)?)?|m[-_]?[nwt]|[nwt][-_]?m", OutputFormat::MATH_NAMES},
 			{"gate-costs", "(?:gates?[-_ ])?(?:costs?|scores?|stat(?:s|istics?)?|infos?)|g[-_ ]?[csi]", OutputFormat::GATE_COSTS},
+			{"pla", "pla|espresso|berkeley(?:[-_ ]pla)?", OutputFormat::PLA},
 		});
 	Text name({"name", "module-name", "class-name"}, 'n');
 	Flag verboseGraph({"verbose-graph", "expanded-graph", "redundant-graph"}, 'G');
+	Flag toBinary({"to-binary", "convert-to-binary", "binary-output", "dump-binary"}, 'B');
+	
+	Number<unsigned> jobs({"jobs", "threads", "job-count", "thread-count"}, 'j', 1, 1024, [](){
+			return std::max(1u, std::thread::hardware_concurrency());
+		});
+	Flag batch({"batch", "batch-mode", "multiple-problems"}, 'b');
+	Flag statistics({"statistics", "stats", "print-statistics", "show-statistics"}, 'V');
+	Number<unsigned> timeLimit({"time-limit", "timeout", "max-time", "deadline"}, 't', 0, 1000000000, [](){
+			return 0u;
+		});
+	
+	Mapped<MergeMethod, MergeMethod::HASH_TABLE> mergeMethod({"merge", "merging", "merge-method", "merging-method", "merge-algorithm", "merging-algorithm"}, 'm', {
+			{"hash-table", "hash(?:[-_ ]?(?:table|map|set))?|h(?:[-_]?[tms])?|prob(?:e|ing)|default", MergeMethod::HASH_TABLE},
+			{"buckets", "buckets?|b|groups?|g|pair(?:s|wise)|p", MergeMethod::BUCKETS},
+		});
+	Mapped<CoverMethod, CoverMethod::PETRICK> coverMethod({"cover", "cover-method", "covering", "covering-method"}, 'c', {
+			{"petrick", "petrick(?:'?s)?(?:[-_ ]method)?|p|all|expand(?:ing|sion)?|default", CoverMethod::PETRICK},
+			{"branch-and-bound", "branch[-_ ]?(?:and|&|n)[-_ ]?bound|b(?:&|[-_]?(?:and|n)[-_]?)?b|minimal|min", CoverMethod::BRANCH_AND_BOUND},
+		});
+	Number<unsigned> costSlack({"cost-slack", "slack", "max-extra-cost"}, 'k', 0, 1000000, [](){
+			return 0u;
+		});
+	Mapped<ProductStore, ProductStore::AUTO> productStore({"product-store", "products", "store", "expansion-store"}, 'e', {
+			{"auto", "auto(?:matic)?|a|default", ProductStore::AUTO},
+			{"hasse-diagram", "hasse(?:[-_ ]?diagram)?|h|trie|t|tree", ProductStore::HASSE_DIAGRAM},
+			{"bitsets", "bit[-_ ]?(?:sets?|masks?|fields?)|b|words?|w", ProductStore::BITSETS},
+		});
+	Trilean reduce({"reduce", "reduction", "reductions", "cyclic-core"}, 'r', [](){
+			// Dominated prime implicants are useless only when just the cheapest covers are needed.
+			return skipOptimization.isRaised() || (coverMethod.getValue() == CoverMethod::BRANCH_AND_BOUND && costSlack.getValue() == 0);
+		});
 	
 	Flag skipOptimization({"no-optimize", "no-cse", "no-optimization", "skip-optimize", "skip-cse", "skip-optimization"}, 'O');
+	Number<unsigned> cseMargin({"cse-margin", "cse-cost-margin", "solution-margin"}, 'M', 0, 1000000, [](){
+			return std::numeric_limits<unsigned>::max();
+		});
+	Number<unsigned> cseCacheSize({"cse-cache", "cse-cache-size", "optimization-cache", "optimization-cache-size"}, 'C', 0, 1000000000, [](){
+			return 4096u;
+		});
+	Mapped<CseMethod, CseMethod::EXHAUSTIVE> cseMethod({"cse-method", "optimization-method", "elimination-method"}, 'E', {
+			{"exhaustive", "exhaustive|e|exact|brute[-_ ]?force|b|all|default", CseMethod::EXHAUSTIVE},
+			{"greedy", "greedy|g|heuristic|h|fast|f", CseMethod::GREEDY},
+			{"seeded", "seeded|s|hybrid|greedy[-_ ]?(?:then|and|\\+)[-_ ]?exhaustive", CseMethod::SEEDED},
+		});
 	
 	std::vector<std::string_view> freeArgs;
 	
 	
-	static const optionList_t allOptions = {&help, &helpOptions, &version, &prompt, &prompt.getNegatedOption(), &status, &status.getNegatedOption(), &outputFormat, &name, &verboseGraph, &skipOptimization};
+	static const optionList_t allOptions = {&help, &helpOptions, &version, &prompt, &prompt.getNegatedOption(), &status, &status.getNegatedOption(), &outputFormat, &name, &verboseGraph, &toBinary, &jobs, &batch, &statistics, &timeLimit, &mergeMethod, &coverMethod, &costSlack, &productStore, &reduce, &reduce.getNegatedOption(), &skipOptimization, &cseMargin, &cseCacheSize, &cseMethod};
 	
 	bool parse(const int argc, const char *const *const argv)
 	{
 		return parse(argc, argv, allOptions, freeArgs);
 	}
 	
+	void resolveDefaults()
+	{
+		// Options are resolved in the order of the list, so a default can depend only on the options that are before it.
+		for (Option *const option : allOptions)
+			option->resolveDefault();
+	}
+	
 }
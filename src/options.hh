@@ -24,6 +24,33 @@ namespace options
 		MATH_PROG,
 		MATH_NAMES,
 		GATE_COSTS,
+		PLA,
+	};
+	
+	enum class MergeMethod
+	{
+		HASH_TABLE,
+		BUCKETS,
+	};
+	
+	enum class CoverMethod
+	{
+		PETRICK,
+		BRANCH_AND_BOUND,
+	};
+	
+	enum class ProductStore
+	{
+		AUTO,
+		HASSE_DIAGRAM,
+		BITSETS,
+	};
+	
+	enum class CseMethod
+	{
+		EXHAUSTIVE,
+		GREEDY,
+		SEEDED,
 	};
 	
 	extern Flag help;
@@ -36,12 +63,29 @@ namespace options
 	extern Mapped<OutputFormat, OutputFormat::HUMAN_LONG> outputFormat;
 	extern Text name;
 	extern Flag verboseGraph;
+	extern Flag toBinary;
+	
+	extern Number<unsigned> jobs;
+	extern Flag batch;
+	extern Flag statistics;
+	extern Number<unsigned> timeLimit;
+	
+	extern Mapped<MergeMethod, MergeMethod::HASH_TABLE> mergeMethod;
+	extern Mapped<CoverMethod, CoverMethod::PETRICK> coverMethod;
+	extern Number<unsigned> costSlack;
+	extern Mapped<ProductStore, ProductStore::AUTO> productStore;
+	extern Trilean reduce;
 	
 	extern Flag skipOptimization;
+	extern Number<unsigned> cseMargin;
+	extern Number<unsigned> cseCacheSize;
+	extern Mapped<CseMethod, CseMethod::EXHAUSTIVE> cseMethod;
 	
 	extern std::vector<std::string_view> freeArgs;
 	
 	
 	[[nodiscard]] bool parse(const int argc, const char *const *const argv);
+	// Some defaults depend on the global state (e.g. whether the input is a terminal), so this is called once it is known. After that, the options can be read from many threads at once.
+	void resolveDefaults();
 	
 }
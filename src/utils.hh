@@ -1,8 +1,12 @@
 #pragma once
 
 #include <algorithm>
+#include <cstddef>
+#include <thread>
 #include <vector>
 
+#include "global.hh"
+
 
 // An object of this class casts to `true` the first time and to `false` every other time.
 class First
@@ -21,3 +25,24 @@ std::vector<OT> map_vector(const std::vector<IT> &in, OP op)
 	std::transform(in.cbegin(), in.cend(), std::back_inserter(out), op);
 	return out;
 }
+
+
+// Calls `function(threadIndex)` for every `threadIndex` in range `[0, threadCount)`, each in a separate thread. (Index 0 runs in the calling thread.)
+// The new threads get a copy of the description of inputs from the calling thread.
+template<class F>
+void runInParallel(const std::size_t threadCount, F function)
+{
+	if (threadCount <= 1)
+	{
+		function(std::size_t(0));
+		return;
+	}
+	std::vector<std::thread> threads;
+	threads.reserve(threadCount - 1);
+	const InputsState inputsState = InputsState::save();
+	for (std::size_t i = 1; i < threadCount; ++i)
+		threads.emplace_back([&function, &inputsState, i](){ inputsState.restore(); function(i); });
+	function(std::size_t(0));
+	for (std::thread &thread : threads)
+		thread.join();
+}